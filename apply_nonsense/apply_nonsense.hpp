@@ -0,0 +1,155 @@
+/**
+ * @brief Fixed size array operations expanded over index sequences
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef APPLY_NONSENSE_HPP
+#define APPLY_NONSENSE_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace mguid {
+
+/**
+ * Everything here indexes the array directly inside a pack expansion, so no
+ * element is copied into an intermediate std::tuple.
+ *
+ * fold, transform, zip and static_for take an optional NChunk. With the
+ * default of 0 the whole array is expanded as one pack; otherwise it is
+ * expanded NChunk indices at a time, which keeps each fold expression (and
+ * so the compiler's work per instantiation) at NChunk terms however large
+ * the array is. The results are the same either way.
+ */
+
+template <typename T>
+inline constexpr bool is_std_array_v = false;
+
+template <typename T, std::size_t N>
+inline constexpr bool is_std_array_v<std::array<T, N>> = true;
+
+template <typename T>
+concept StdArray = is_std_array_v<std::remove_cvref_t<T>>;
+
+namespace detail {
+
+template <std::size_t N, std::size_t NChunk>
+inline constexpr std::size_t kChunk = NChunk == 0 || NChunk > N ? N : NChunk;
+
+// Calls func(integral_constant<NOffset + NIdx>) for each NIdx, in order
+template <std::size_t NOffset, typename TFunc, std::size_t... NIdx>
+constexpr void for_each_index(TFunc& func, std::index_sequence<NIdx...>) {
+  (func(std::integral_constant<std::size_t, NOffset + NIdx>{}), ...);
+}
+
+template <std::size_t NChunk, typename TFunc, std::size_t... NChunkIdx>
+constexpr void for_each_chunk(TFunc& func,
+                              std::index_sequence<NChunkIdx...>) {
+  (for_each_index<NChunkIdx * NChunk>(func,
+                                      std::make_index_sequence<NChunk>{}),
+   ...);
+}
+
+template <std::size_t N, std::size_t NChunk, typename TFunc>
+constexpr void for_each_index_chunked(TFunc& func) {
+  if constexpr (N > 0) {
+    constexpr auto kSize = kChunk<N, NChunk>;
+    for_each_chunk<kSize>(func, std::make_index_sequence<N / kSize>{});
+    for_each_index<N - N % kSize>(func,
+                                  std::make_index_sequence<N % kSize>{});
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Call func(integral_constant<std::size_t, 0>{}), ... up to N - 1
+ */
+template <std::size_t N, std::size_t NChunk = 0, typename TFunc>
+constexpr void static_for(TFunc&& func) {
+  detail::for_each_index_chunked<N, NChunk>(func);
+}
+
+/**
+ * @brief func(arr[0], ..., arr[N - 1]), elements forwarded with the array's
+ * value category
+ */
+template <typename TFunc, StdArray TArray>
+constexpr decltype(auto) apply(TFunc&& func, TArray&& arr) {
+  constexpr auto kSize = std::tuple_size_v<std::remove_cvref_t<TArray>>;
+  return [&]<std::size_t... NIdx>(std::index_sequence<NIdx...>)
+      -> decltype(auto) {
+    return std::invoke(std::forward<TFunc>(func),
+                       std::get<NIdx>(std::forward<TArray>(arr))...);
+  }(std::make_index_sequence<kSize>{});
+}
+
+/**
+ * @brief op(...op(op(init, arr[0]), arr[1])..., arr[N - 1])
+ */
+template <std::size_t NChunk = 0, typename T, std::size_t N, typename TAcc,
+          typename TOp>
+constexpr TAcc fold(const std::array<T, N>& arr, TAcc init, TOp&& op) {
+  auto step = [&](auto idx) {
+    init = std::invoke(op, std::move(init), arr[idx]);
+  };
+  detail::for_each_index_chunked<N, NChunk>(step);
+  return init;
+}
+
+/**
+ * @brief {func(arr[0]), ..., func(arr[N - 1])}
+ *
+ * Unchunked, the result is initialized directly from the calls. Chunked, it
+ * is default constructed and assigned, so the result type has to allow that.
+ */
+template <std::size_t NChunk = 0, typename T, std::size_t N, typename TFunc>
+constexpr auto transform(const std::array<T, N>& arr, TFunc&& func) {
+  using Result = std::remove_cvref_t<std::invoke_result_t<TFunc&, const T&>>;
+  if constexpr (detail::kChunk<N, NChunk> == N) {
+    return [&]<std::size_t... NIdx>(std::index_sequence<NIdx...>) {
+      return std::array<Result, N>{std::invoke(func, arr[NIdx])...};
+    }(std::make_index_sequence<N>{});
+  } else {
+    std::array<Result, N> out;
+    auto step = [&](auto idx) { out[idx] = std::invoke(func, arr[idx]); };
+    detail::for_each_index_chunked<N, NChunk>(step);
+    return out;
+  }
+}
+
+/**
+ * @brief {func(first[0], rest[0]...), ...} up to index N - 1
+ *
+ * Same chunking rules as transform.
+ */
+template <std::size_t NChunk = 0, typename TFunc, typename T, std::size_t N,
+          typename... TRest>
+constexpr auto zip(TFunc&& func, const std::array<T, N>& first,
+                   const std::array<TRest, N>&... rest) {
+  using Result = std::remove_cvref_t<
+      std::invoke_result_t<TFunc&, const T&, const TRest&...>>;
+  // Takes one index so the rest... expansion doesn't meet the index pack
+  auto at = [&](auto idx) -> Result {
+    return std::invoke(func, first[idx], rest[idx]...);
+  };
+  if constexpr (detail::kChunk<N, NChunk> == N) {
+    return [&]<std::size_t... NIdx>(std::index_sequence<NIdx...>) {
+      return std::array<Result, N>{
+          at(std::integral_constant<std::size_t, NIdx>{})...};
+    }(std::make_index_sequence<N>{});
+  } else {
+    std::array<Result, N> out;
+    auto step = [&](auto idx) { out[idx] = at(idx); };
+    detail::for_each_index_chunked<N, NChunk>(step);
+    return out;
+  }
+}
+
+}  // namespace mguid
+
+#endif  // APPLY_NONSENSE_HPP
@@ -0,0 +1,123 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "apply_nonsense.hpp"
+
+namespace {
+
+// The original tuple based apply, kept as the baseline
+template <typename TArray, std::size_t... TIntSeq>
+constexpr auto array_to_tuple_impl(const TArray& a,
+                                   std::index_sequence<TIntSeq...>) noexcept {
+  return std::make_tuple(a[TIntSeq]...);
+}
+
+template <typename TFunc, typename T, std::size_t N>
+constexpr decltype(auto) tuple_apply(TFunc&& func,
+                                     const std::array<T, N>& arr) {
+  return std::apply(std::forward<TFunc>(func),
+                    array_to_tuple_impl(arr, std::make_index_sequence<N>{}));
+}
+
+// Keeps the optimizer from discarding the work being measured
+volatile std::uint64_t g_sink{0};
+volatile int g_seed{1};
+
+// Makes the compiler assume memory changed, so repetitions aren't folded
+void clobber_memory() { asm volatile("" : : : "memory"); }
+
+// Makes the compiler assume pointer's target is read, so stores to it stay
+void escape(void* pointer) { asm volatile("" : : "g"(pointer) : "memory"); }
+
+template <std::size_t N, typename TFunc>
+double ns_per_element(std::size_t elements, TFunc&& func) {
+  const std::size_t reps = elements / N;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t rep{0}; rep < reps; ++rep) {
+    func();
+    clobber_memory();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() /
+         static_cast<double>(reps * N);
+}
+
+template <std::size_t N>
+void bench_size(std::size_t elements) {
+  std::array<int, N> arr{};
+  for (std::size_t idx{0}; idx < N; ++idx) {
+    arr[idx] = g_seed + static_cast<int>(idx);
+  }
+  const auto add = [](int acc, int val) { return acc + val; };
+  const auto step = [](int val) { return val * 3 + 1; };
+  const auto sink = [](int value) {
+    g_sink = g_sink + static_cast<std::uint64_t>(value);
+  };
+
+  const auto loop_sum = ns_per_element<N>(elements, [&] {
+    int sum{0};
+    for (std::size_t idx{0}; idx < N; ++idx) {
+      sum += arr[idx];
+    }
+    sink(sum);
+  });
+  const auto fold_sum = ns_per_element<N>(
+      elements, [&] { sink(mguid::fold(arr, 0, add)); });
+  const auto chunked_sum = ns_per_element<N>(
+      elements, [&] { sink(mguid::fold<16>(arr, 0, add)); });
+  const auto apply_sum = ns_per_element<N>(elements, [&] {
+    sink(mguid::apply([](auto... vals) { return (0 + ... + vals); }, arr));
+  });
+  // At N = 256 the tuple version alone takes g++ 12 over six minutes at -O2
+  double tuple_sum{0};
+  if constexpr (N <= 64) {
+    tuple_sum = ns_per_element<N>(elements, [&] {
+      sink(tuple_apply([](auto... vals) { return (0 + ... + vals); }, arr));
+    });
+  }
+
+  std::array<int, N> out{};
+  escape(out.data());
+  const auto loop_transform = ns_per_element<N>(elements, [&] {
+    for (std::size_t idx{0}; idx < N; ++idx) {
+      out[idx] = step(arr[idx]);
+    }
+  });
+  const auto transform = ns_per_element<N>(
+      elements, [&] { out = mguid::transform(arr, step); });
+  const auto chunked_transform = ns_per_element<N>(
+      elements, [&] { out = mguid::transform<16>(arr, step); });
+  sink(out[N - 1]);
+
+  std::cout << N << '\t' << loop_sum << '\t' << fold_sum << '\t'
+            << chunked_sum << '\t' << apply_sum << '\t';
+  if constexpr (N <= 64) {
+    std::cout << tuple_sum;
+  } else {
+    std::cout << '-';
+  }
+  std::cout << '\t' << loop_transform << '\t' << transform << '\t'
+            << chunked_transform << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t elements = argc > 1 ? std::stoul(argv[1]) : 100'000'000;
+  std::cout << "ns per element\n";
+  std::cout << "N\tloop sum\tfold\tfold<16>\tapply\ttuple apply\t"
+               "loop transform\ttransform\ttransform<16>\n";
+  bench_size<4>(elements);
+  bench_size<16>(elements);
+  bench_size<64>(elements);
+  // The tuple column stops at 64; the "apply N=..." subjects of
+  // compile_cost/compile_cost_bench show what larger N costs to compile
+  bench_size<256>(elements);
+  bench_size<1024>(elements);
+}
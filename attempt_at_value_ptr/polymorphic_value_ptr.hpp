@@ -0,0 +1,206 @@
+/**
+ * @brief Value semantic pointer to a class hierarchy, copied without slicing
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef POLYMORPHIC_VALUE_PTR_HPP
+#define POLYMORPHIC_VALUE_PTR_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mguid {
+
+/**
+ * @brief Owns an object of any type derived from TBase and copies it as that
+ * dynamic type
+ *
+ * The copy, move and destroy operations of the concrete type are captured in
+ * a static table when the object is constructed, so the hierarchy needs no
+ * virtual clone() (or even a virtual destructor). Objects up to NSize bytes
+ * and NAlign alignment with a non-throwing move constructor are stored inline;
+ * anything else gets its own heap allocation.
+ *
+ * The concrete type is the static type at construction: building one from a
+ * TBase& that refers to a Derived copies only the TBase part. A moved-from
+ * PolymorphicValuePtr is empty.
+ */
+template <typename TBase, std::size_t NSize = 4 * sizeof(void*),
+         std::size_t NAlign = alignof(std::max_align_t)>
+class PolymorphicValuePtr {
+ // The buffer doubles as the slot for the heap pointer
+ static constexpr std::size_t kBufferSize =
+     NSize < sizeof(void*) ? sizeof(void*) : NSize;
+ static constexpr std::size_t kBufferAlign =
+     NAlign < alignof(void*) ? alignof(void*) : NAlign;
+
+ template <typename TDerived>
+ static constexpr bool kFits =
+     sizeof(TDerived) <= kBufferSize && alignof(TDerived) <= kBufferAlign &&
+     kBufferAlign % alignof(TDerived) == 0 &&
+     std::is_nothrow_move_constructible_v<TDerived>;
+
+ struct Ops {
+   void (*copy)(const PolymorphicValuePtr& from, PolymorphicValuePtr& to);
+   // Only called for inline objects; heap objects move by pointer
+   void (*move)(PolymorphicValuePtr& from, PolymorphicValuePtr& to) noexcept;
+   void (*destroy)(PolymorphicValuePtr& self) noexcept;
+   bool stored_inline;
+ };
+
+ template <typename TDerived>
+ static void CopyAs(const PolymorphicValuePtr& from, PolymorphicValuePtr& to) {
+   to.Construct<TDerived>(*static_cast<const TDerived*>(from.Object()));
+ }
+
+ template <typename TDerived>
+ static void MoveAs(PolymorphicValuePtr& from,
+                    PolymorphicValuePtr& to) noexcept {
+   to.Construct<TDerived>(std::move(*static_cast<TDerived*>(from.Object())));
+ }
+
+ template <typename TDerived>
+ static void DestroyAs(PolymorphicValuePtr& self) noexcept {
+   auto* object = static_cast<TDerived*>(self.Object());
+   if constexpr (kFits<TDerived>) {
+     object->~TDerived();
+   } else {
+     delete object;
+   }
+ }
+
+ template <typename TDerived>
+ static constexpr Ops kOpsFor{&CopyAs<TDerived>, &MoveAs<TDerived>,
+                              &DestroyAs<TDerived>, kFits<TDerived>};
+
+public:
+ // Whether a TDerived would be stored inside the PolymorphicValuePtr
+ template <typename TDerived>
+ static constexpr bool kStoresInline = kFits<TDerived>;
+
+ constexpr PolymorphicValuePtr()
+   requires(!std::is_default_constructible_v<TBase> ||
+            std::is_abstract_v<TBase>)
+ = delete;
+
+ PolymorphicValuePtr()
+   requires(std::is_default_constructible_v<TBase> &&
+            !std::is_abstract_v<TBase>)
+ {
+   Construct<TBase>();
+ }
+
+ template <typename TDerived, typename... TArgs>
+ explicit PolymorphicValuePtr(std::in_place_type_t<TDerived>, TArgs&&... args)
+   requires(std::derived_from<TDerived, TBase> &&
+            std::copy_constructible<TDerived> &&
+            std::is_constructible_v<TDerived, TArgs && ...>)
+ {
+   Construct<TDerived>(std::forward<TArgs>(args)...);
+ }
+
+ template <typename TDerived>
+ PolymorphicValuePtr(TDerived&& value)
+   requires(!std::same_as<std::remove_cvref_t<TDerived>, PolymorphicValuePtr> &&
+            std::derived_from<std::remove_cvref_t<TDerived>, TBase> &&
+            std::copy_constructible<std::remove_cvref_t<TDerived>>)
+ {
+   Construct<std::remove_cvref_t<TDerived>>(std::forward<TDerived>(value));
+ }
+
+ PolymorphicValuePtr(const PolymorphicValuePtr& other) {
+   if (other.m_ops != nullptr) { other.m_ops->copy(other, *this); }
+ }
+
+ PolymorphicValuePtr(PolymorphicValuePtr&& other) noexcept {
+   TakeFrom(other);
+ }
+
+ PolymorphicValuePtr& operator=(const PolymorphicValuePtr& other) {
+   if (&other != this) {
+     PolymorphicValuePtr copy{other};
+     Reset();
+     TakeFrom(copy);
+   }
+   return *this;
+ }
+
+ PolymorphicValuePtr& operator=(PolymorphicValuePtr&& other) noexcept {
+   if (&other != this) {
+     Reset();
+     TakeFrom(other);
+   }
+   return *this;
+ }
+
+ ~PolymorphicValuePtr() { Reset(); }
+
+ friend void swap(PolymorphicValuePtr& lhs, PolymorphicValuePtr& rhs) noexcept {
+   PolymorphicValuePtr tmp{std::move(lhs)};
+   lhs = std::move(rhs);
+   rhs = std::move(tmp);
+ }
+
+ const TBase& operator*() const { return *m_ptr; }
+ TBase& operator*() { return *m_ptr; }
+ const TBase* operator->() const { return m_ptr; }
+ TBase* operator->() { return m_ptr; }
+
+private:
+ template <typename TDerived, typename... TArgs>
+ void Construct(TArgs&&... args) {
+   TDerived* object;
+   if constexpr (kFits<TDerived>) {
+     object = ::new (static_cast<void*>(m_buffer))
+         TDerived(std::forward<TArgs>(args)...);
+   } else {
+     object = new TDerived(std::forward<TArgs>(args)...);
+     ::new (static_cast<void*>(m_buffer)) void*(object);
+   }
+   m_ptr = object;
+   m_ops = &kOpsFor<TDerived>;
+ }
+
+ [[nodiscard]] void* Object() const noexcept {
+   if (m_ops->stored_inline) { return const_cast<std::byte*>(m_buffer); }
+   return *std::launder(reinterpret_cast<void* const*>(m_buffer));
+ }
+
+ void TakeFrom(PolymorphicValuePtr& other) noexcept {
+   if (other.m_ops == nullptr) { return; }
+   if (other.m_ops->stored_inline) {
+     other.m_ops->move(other, *this);
+     other.Reset();
+   } else {
+     ::new (static_cast<void*>(m_buffer)) void*(other.Object());
+     m_ptr = std::exchange(other.m_ptr, nullptr);
+     m_ops = std::exchange(other.m_ops, nullptr);
+   }
+ }
+
+ void Reset() noexcept {
+   if (m_ops != nullptr) {
+     m_ops->destroy(*this);
+     m_ops = nullptr;
+     m_ptr = nullptr;
+   }
+ }
+
+ const Ops* m_ops{nullptr};
+ TBase* m_ptr{nullptr};
+ alignas(kBufferAlign) std::byte m_buffer[kBufferSize];
+};
+
+template <typename TBase, typename TDerived = TBase, typename... TArgs>
+PolymorphicValuePtr<TBase> MakePolymorphicValuePtr(TArgs&&... args) {
+ return PolymorphicValuePtr<TBase>(std::in_place_type<TDerived>,
+                                   std::forward<TArgs>(args)...);
+}
+
+}  // namespace mguid
+
+#endif  // POLYMORPHIC_VALUE_PTR_HPP
@@ -7,8 +7,13 @@
 #ifndef VALUE_PTR_HPP
 #define VALUE_PTR_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 namespace mguid {
 
@@ -22,74 +27,501 @@ template <class TType, template <class...> class TPrimary>
 inline constexpr bool IsSpecializationOfV =
    IsSpecializationOf<TType, TPrimary>::value;
 
-template <typename TValueType>
+/**
+ * @brief Storage policy that keeps the value in its own heap allocation
+ *
+ * This is the original ValuePtr behaviour: moves steal the pointer and leave
+ * the source empty.
+ */
+struct HeapStorage {
+ template <typename TValueType>
+ class Holder {
+ public:
+   static constexpr bool kInline = false;
+
+   constexpr Holder() noexcept = default;
+
+   template <typename... TArgs>
+   constexpr explicit Holder(std::in_place_t, TArgs&&... args)
+       : m_ptr{std::make_unique<TValueType>(std::forward<TArgs>(args)...)} {}
+
+   constexpr Holder(const Holder& other)
+       : m_ptr{other.m_ptr ? std::make_unique<TValueType>(*other.m_ptr)
+                           : nullptr} {}
+
+   constexpr Holder(Holder&& other) noexcept = default;
+
+   // Builds a fresh copy rather than assigning through, as ValuePtr always has
+   constexpr Holder& operator=(const Holder& other) {
+     m_ptr = other.m_ptr ? std::make_unique<TValueType>(*other.m_ptr) : nullptr;
+     return *this;
+   }
+
+   constexpr Holder& operator=(Holder&& other) noexcept = default;
+
+   template <typename... TArgs>
+   constexpr void Emplace(TArgs&&... args) {
+     m_ptr = std::make_unique<TValueType>(std::forward<TArgs>(args)...);
+   }
+
+   constexpr void Swap(Holder& other) noexcept {
+     std::swap(m_ptr, other.m_ptr);
+   }
+
+   constexpr TValueType* Get() noexcept { return m_ptr.get(); }
+   constexpr const TValueType* Get() const noexcept { return m_ptr.get(); }
+
+ private:
+   std::unique_ptr<TValueType> m_ptr{nullptr};
+ };
+};
+
+/**
+ * @brief Storage policy that keeps values of up to NSize bytes and NAlign
+ * alignment inside the ValuePtr itself
+ *
+ * Larger or over-aligned types, and types whose move constructor may throw,
+ * silently use HeapStorage instead; the choice is made per type at compile
+ * time, so there is no runtime flag. Inline values are never empty: a moved
+ * from ValuePtr keeps a moved-from value rather than becoming null.
+ */
+template <std::size_t NSize = 4 * sizeof(void*),
+         std::size_t NAlign = alignof(std::max_align_t)>
+struct InlineStorage {
+ template <typename TValueType>
+ static constexpr bool kFits =
+     sizeof(TValueType) <= NSize && alignof(TValueType) <= NAlign &&
+     NAlign % alignof(TValueType) == 0 &&
+     std::is_nothrow_move_constructible_v<TValueType>;
+
+ template <typename TValueType>
+ class Buffer {
+ public:
+   static constexpr bool kInline = true;
+
+   template <typename... TArgs>
+   explicit Buffer(std::in_place_t, TArgs&&... args) noexcept(
+       std::is_nothrow_constructible_v<TValueType, TArgs&&...>) {
+     ::new (static_cast<void*>(m_storage))
+         TValueType(std::forward<TArgs>(args)...);
+   }
+
+   Buffer(const Buffer& other) noexcept(
+       std::is_nothrow_copy_constructible_v<TValueType>)
+       : Buffer{std::in_place, *other.Get()} {}
+
+   Buffer(Buffer&& other) noexcept
+       : Buffer{std::in_place, std::move(*other.Get())} {}
+
+   Buffer& operator=(const Buffer& other) noexcept(
+       std::is_nothrow_copy_assignable_v<TValueType>) {
+     if (&other != this) { *Get() = *other.Get(); }
+     return *this;
+   }
+
+   Buffer& operator=(Buffer&& other) noexcept(
+       std::is_nothrow_move_assignable_v<TValueType>) {
+     if (&other != this) { *Get() = std::move(*other.Get()); }
+     return *this;
+   }
+
+   ~Buffer() { Get()->~TValueType(); }
+
+   // Builds the replacement before destroying the old value whenever that
+   // construction could throw, so a Buffer always holds a value
+   template <typename... TArgs>
+   void Emplace(TArgs&&... args) {
+     if constexpr (std::is_nothrow_constructible_v<TValueType, TArgs&&...>) {
+       Get()->~TValueType();
+       ::new (static_cast<void*>(m_storage))
+           TValueType(std::forward<TArgs>(args)...);
+     } else {
+       TValueType replacement(std::forward<TArgs>(args)...);
+       Get()->~TValueType();
+       ::new (static_cast<void*>(m_storage)) TValueType(std::move(replacement));
+     }
+   }
+
+   void Swap(Buffer& other) noexcept {
+     using std::swap;
+     if constexpr (std::is_nothrow_swappable_v<TValueType>) {
+       swap(*Get(), *other.Get());
+     } else {
+       TValueType tmp(std::move(*Get()));
+       Emplace(std::move(*other.Get()));
+       other.Emplace(std::move(tmp));
+     }
+   }
+
+   TValueType* Get() noexcept {
+     return std::launder(reinterpret_cast<TValueType*>(m_storage));
+   }
+   const TValueType* Get() const noexcept {
+     return std::launder(reinterpret_cast<const TValueType*>(m_storage));
+   }
+
+ private:
+   alignas(NAlign) std::byte m_storage[NSize];
+ };
+
+ template <typename TValueType>
+ using Holder = std::conditional_t<kFits<TValueType>, Buffer<TValueType>,
+                                   HeapStorage::Holder<TValueType>>;
+};
+
+/**
+ * @brief Storage policy that allocates the value through TAllocator
+ *
+ * The allocator is rebound to the value type and uses-allocator construction
+ * is applied, so allocator-aware members of the value share its arena. Like
+ * the pmr containers, a ValuePtr keeps the allocator it was constructed with:
+ * copies get select_on_container_copy_construction, and assignment between
+ * ValuePtrs with unequal allocators copies or moves the value across rather
+ * than propagating the allocator.
+ */
+template <typename TAllocator = std::allocator<std::byte>>
+struct AllocatorStorage {
+ template <typename TValueType>
+ class Holder {
+   using Alloc = typename std::allocator_traits<
+       TAllocator>::template rebind_alloc<TValueType>;
+   using Traits = std::allocator_traits<Alloc>;
+
+ public:
+   static constexpr bool kInline = false;
+
+   Holder() = default;
+
+   template <typename... TArgs>
+   explicit Holder(std::in_place_t, TArgs&&... args)
+       : m_ptr{Create(m_alloc, std::forward<TArgs>(args)...)} {}
+
+   template <typename TOtherAlloc, typename... TArgs>
+   Holder(std::allocator_arg_t, const TOtherAlloc& alloc, TArgs&&... args)
+       : m_alloc{alloc}, m_ptr{Create(m_alloc, std::forward<TArgs>(args)...)} {}
+
+   Holder(const Holder& other)
+       : m_alloc{Traits::select_on_container_copy_construction(other.m_alloc)},
+         m_ptr{other.m_ptr ? Create(m_alloc, std::as_const(*other.m_ptr))
+                           : nullptr} {}
+
+   Holder(Holder&& other) noexcept
+       : m_alloc{other.m_alloc}, m_ptr{std::exchange(other.m_ptr, nullptr)} {}
+
+   Holder& operator=(const Holder& other) {
+     if (other.m_ptr) {
+       Emplace(std::as_const(*other.m_ptr));
+     } else {
+       Destroy(m_alloc, std::exchange(m_ptr, nullptr));
+     }
+     return *this;
+   }
+
+   // Moving across unequal allocators allocates, so this can only be
+   // noexcept when all allocators of the type compare equal
+   Holder& operator=(Holder&& other) noexcept(
+       Traits::is_always_equal::value) {
+     if (&other == this) { return *this; }
+     if (m_alloc == other.m_alloc || other.m_ptr == nullptr) {
+       auto* stolen = std::exchange(other.m_ptr, nullptr);
+       Destroy(m_alloc, std::exchange(m_ptr, stolen));
+     } else {
+       Emplace(std::move(*other.m_ptr));
+     }
+     return *this;
+   }
+
+   ~Holder() { Destroy(m_alloc, m_ptr); }
+
+   template <typename... TArgs>
+   void Emplace(TArgs&&... args) {
+     auto* replacement = Create(m_alloc, std::forward<TArgs>(args)...);
+     Destroy(m_alloc, std::exchange(m_ptr, replacement));
+   }
+
+   // Unequal allocators keep their memory, so values move between them; an
+   // empty side gets a value allocated from its own allocator
+   void Swap(Holder& other) noexcept(Traits::is_always_equal::value) {
+     if (m_alloc == other.m_alloc) {
+       std::swap(m_ptr, other.m_ptr);
+     } else if (m_ptr != nullptr && other.m_ptr != nullptr) {
+       using std::swap;
+       swap(*m_ptr, *other.m_ptr);
+     } else if (m_ptr != nullptr) {
+       other.Emplace(std::move(*m_ptr));
+       Destroy(m_alloc, std::exchange(m_ptr, nullptr));
+     } else if (other.m_ptr != nullptr) {
+       Emplace(std::move(*other.m_ptr));
+       Destroy(other.m_alloc, std::exchange(other.m_ptr, nullptr));
+     }
+   }
+
+   TValueType* Get() noexcept { return m_ptr; }
+   const TValueType* Get() const noexcept { return m_ptr; }
+
+ private:
+   template <typename... TArgs>
+   static TValueType* Create(Alloc& alloc, TArgs&&... args) {
+     TValueType* ptr = Traits::allocate(alloc, 1);
+     try {
+       std::uninitialized_construct_using_allocator(
+           ptr, alloc, std::forward<TArgs>(args)...);
+     } catch (...) {
+       Traits::deallocate(alloc, ptr, 1);
+       throw;
+     }
+     return ptr;
+   }
+
+   static void Destroy(Alloc& alloc, TValueType* ptr) noexcept {
+     if (ptr != nullptr) {
+       Traits::destroy(alloc, ptr);
+       Traits::deallocate(alloc, ptr, 1);
+     }
+   }
+
+   [[no_unique_address]] Alloc m_alloc{};
+   TValueType* m_ptr{nullptr};
+ };
+};
+
+// Values allocated from a std::pmr::memory_resource, e.g. a monotonic arena
+using PmrStorage =
+   AllocatorStorage<std::pmr::polymorphic_allocator<std::byte>>;
+
+/**
+ * @brief Reference count for CopyOnWrite values shared within one thread
+ */
+class NonAtomicRefCount {
+public:
+ void Increment() noexcept { ++m_count; }
+ // Returns true when the last reference was dropped
+ bool Decrement() noexcept { return --m_count == 0; }
+ [[nodiscard]] bool Unique() const noexcept { return m_count == 1; }
+
+private:
+ std::size_t m_count{1};
+};
+
+/**
+ * @brief Reference count for CopyOnWrite values whose copies cross threads
+ */
+class AtomicRefCount {
+public:
+ void Increment() noexcept { m_count.fetch_add(1, std::memory_order_relaxed); }
+ bool Decrement() noexcept {
+   return m_count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+ }
+ [[nodiscard]] bool Unique() const noexcept {
+   return m_count.load(std::memory_order_acquire) == 1;
+ }
+
+private:
+ std::atomic<std::size_t> m_count{1};
+};
+
+/**
+ * @brief Storage policy where copies share one reference counted value until
+ * one of them is accessed mutably
+ *
+ * Not a drop-in replacement for deep copying, which is why ValuePtr only uses
+ * it when asked to by name. With HeapStorage every ValuePtr owns its value;
+ * here a ValuePtr owns it only after its first non-const access, and a const
+ * reference taken before that points into the shared value:
+ *
+ *   auto b = a;
+ *   const int& r = *std::as_const(a);
+ *   *a = 2;  // a now owns a clone; r still reads b's value, 1
+ *
+ * r also dangles once a and b are both gone. Code that holds const references
+ * into a ValuePtr across writes through it must stay with HeapStorage.
+ *
+ * Copies otherwise behave as deep copies. Only the non-const operator* and
+ * operator-> clone, and only when the value is shared; read through a const
+ * ValuePtr (or std::as_const) to avoid that. Once a mutable reference has
+ * been handed out the value is marked unshareable and later copies of that
+ * ValuePtr deep copy, because the caller may still be writing through it.
+ */
+template <typename TRefCount = AtomicRefCount>
+struct CopyOnWrite {
+ template <typename TValueType>
+ class Holder {
+   struct Block {
+     template <typename... TArgs>
+     explicit Block(std::in_place_t, TArgs&&... args)
+         : value(std::forward<TArgs>(args)...) {}
+
+     TRefCount refs;
+     bool unshareable{false};
+     TValueType value;
+   };
+
+ public:
+   static constexpr bool kInline = false;
+
+   Holder() noexcept = default;
+
+   template <typename... TArgs>
+   explicit Holder(std::in_place_t, TArgs&&... args)
+       : m_block{new Block(std::in_place, std::forward<TArgs>(args)...)} {}
+
+   Holder(const Holder& other) : m_block{Share(other.m_block)} {}
+
+   Holder(Holder&& other) noexcept
+       : m_block{std::exchange(other.m_block, nullptr)} {}
+
+   Holder& operator=(const Holder& other) {
+     Block* shared = Share(other.m_block);
+     Release();
+     m_block = shared;
+     return *this;
+   }
+
+   Holder& operator=(Holder&& other) noexcept {
+     if (&other != this) {
+       Release();
+       m_block = std::exchange(other.m_block, nullptr);
+     }
+     return *this;
+   }
+
+   ~Holder() { Release(); }
+
+   template <typename... TArgs>
+   void Emplace(TArgs&&... args) {
+     auto* block = new Block(std::in_place, std::forward<TArgs>(args)...);
+     Release();
+     m_block = block;
+   }
+
+   void Swap(Holder& other) noexcept { std::swap(m_block, other.m_block); }
+
+   TValueType* Get() {
+     if (m_block == nullptr) { return nullptr; }
+     if (!m_block->refs.Unique()) {
+       auto* clone = new Block(std::in_place, std::as_const(m_block->value));
+       Release();
+       m_block = clone;
+     }
+     m_block->unshareable = true;
+     return &m_block->value;
+   }
+   const TValueType* Get() const noexcept {
+     return m_block ? &m_block->value : nullptr;
+   }
+
+ private:
+   static Block* Share(Block* block) {
+     if (block == nullptr) { return nullptr; }
+     if (block->unshareable) {
+       return new Block(std::in_place, std::as_const(block->value));
+     }
+     block->refs.Increment();
+     return block;
+   }
+
+   void Release() noexcept {
+     if (m_block && m_block->refs.Decrement()) { delete m_block; }
+     m_block = nullptr;
+   }
+
+   Block* m_block{nullptr};
+ };
+};
+
+/**
+ * @brief Pointer-like holder with value semantics: copies copy the value
+ * @tparam TStorage where the value lives: HeapStorage, InlineStorage<...>,
+ * CopyOnWrite<...> or AllocatorStorage<...>
+ */
+template <typename TValueType, typename TStorage = HeapStorage>
 class ValuePtr {
+ using Holder = typename TStorage::template Holder<TValueType>;
+
 public:
+ // Whether this instantiation keeps its value inside the ValuePtr
+ static constexpr bool kStoresInline = Holder::kInline;
+
  // DEFAULT CONSTRUCTION
 
  constexpr ValuePtr() requires(!std::is_default_constructible_v<TValueType>) = delete;
 
- constexpr ValuePtr() noexcept(
-     std::is_nothrow_default_constructible_v<TValueType>)
+ constexpr ValuePtr() noexcept(kNothrowConstruct<>)
    requires(std::is_default_constructible_v<TValueType>)
-     : m_ptr{std::make_unique<TValueType>()} {}
+     : m_storage{std::in_place} {}
+
+ // IN-PLACE CONSTRUCTION
+
+ template <typename... TArgs>
+ constexpr explicit ValuePtr(std::in_place_t, TArgs&&... args) noexcept(
+     kNothrowConstruct<TArgs&&...>)
+   requires(std::is_constructible_v<TValueType, TArgs && ...>)
+     : m_storage{std::in_place, std::forward<TArgs>(args)...} {}
+
+ // Only for storage policies that take an allocator, e.g. PmrStorage
+ template <typename TAllocator, typename... TArgs>
+ constexpr ValuePtr(std::allocator_arg_t, const TAllocator& alloc,
+                    TArgs&&... args)
+   requires(std::is_constructible_v<Holder, std::allocator_arg_t,
+                                    const TAllocator&, TArgs && ...>)
+     : m_storage{std::allocator_arg, alloc, std::forward<TArgs>(args)...} {}
 
  // COPY CONSTRUCTION FROM VALUE_PTR<TVALUETYPE>
 
- constexpr ValuePtr(const ValuePtr<TValueType>&)
+ constexpr ValuePtr(const ValuePtr&)
    requires(!std::is_copy_constructible_v<TValueType>)
  = delete;
 
- constexpr ValuePtr(const ValuePtr<TValueType>& other) noexcept(
-     std::is_nothrow_copy_constructible_v<TValueType>)
+ constexpr ValuePtr(const ValuePtr& other) noexcept(
+     std::is_nothrow_copy_constructible_v<Holder>)
    requires(std::is_copy_constructible_v<TValueType>)
 
-     : m_ptr{std::make_unique<TValueType>(*other)} {}
+     : m_storage{other.m_storage} {}
 
  // COPY ASSIGNMENT FROM VALUE_PTR<TVALUETYPE>
 
- constexpr ValuePtr& operator=(const ValuePtr<TValueType>&)
+ constexpr ValuePtr& operator=(const ValuePtr&)
    requires(!std::is_copy_assignable_v<TValueType>)
  = delete;
 
- constexpr ValuePtr& operator=(const ValuePtr<TValueType>& other) noexcept(
-     std::is_nothrow_copy_assignable_v<TValueType>)
+ constexpr ValuePtr& operator=(const ValuePtr& other) noexcept(
+     std::is_nothrow_copy_assignable_v<Holder>)
    requires(std::is_copy_assignable_v<TValueType>)
  {
-   if (&other != this) { m_ptr = std::make_unique<TValueType>(*other); }
+   if (&other != this) { m_storage = other.m_storage; }
    return *this;
  }
 
  // MOVE CONSTRUCTION FROM VALUE_PTR<TVALUETYPE>
 
- constexpr ValuePtr(ValuePtr<TValueType>&&)
+ constexpr ValuePtr(ValuePtr&&)
    requires(!std::is_move_constructible_v<TValueType>)
  = delete;
 
- constexpr ValuePtr(ValuePtr<TValueType>&& other)
+ constexpr ValuePtr(ValuePtr&& other)
 
-     noexcept(std::is_nothrow_move_constructible_v<TValueType>)
+     noexcept(std::is_nothrow_move_constructible_v<Holder>)
    requires(std::is_move_constructible_v<TValueType>)
-     : m_ptr{std::move(other.m_ptr)} {}
+     : m_storage{std::move(other.m_storage)} {}
 
  // MOVE ASSIGNMENT FROM VALUE_PTR<TVALUETYPE>
 
- constexpr ValuePtr& operator=(ValuePtr<TValueType>&&)
+ constexpr ValuePtr& operator=(ValuePtr&&)
    requires(!std::is_move_assignable_v<TValueType>)
  = delete;
 
- constexpr ValuePtr& operator=(ValuePtr<TValueType>&& other) noexcept(
-     std::is_nothrow_move_assignable_v<TValueType>)
+ constexpr ValuePtr& operator=(ValuePtr&& other) noexcept(
+     std::is_nothrow_move_assignable_v<Holder>)
    requires(std::is_move_assignable_v<TValueType>)
  {
-   m_ptr = std::move(other.m_ptr);
+   m_storage = std::move(other.m_storage);
    return *this;
  }
 
  // COPY CONSTRUCT FROM VALUE_PTR<OTHER>
 
  template <typename TOtherType>
- constexpr ValuePtr(const ValuePtr<TOtherType>&)
+ constexpr ValuePtr(const ValuePtr<TOtherType, TStorage>&)
    requires(!std::same_as<std::remove_cvref_t<TOtherType>, TValueType> &&
             !std::is_constructible_v<
                 TValueType, std::add_const_t<std::add_lvalue_reference_t<
@@ -97,20 +529,19 @@ public:
  = delete;
 
  template <typename TOtherType>
- constexpr ValuePtr(const ValuePtr<TOtherType>& other) noexcept(
-     std::is_nothrow_constructible_v<
-         TValueType, std::add_const_t<std::add_lvalue_reference_t<
-                         std::remove_cvref_t<TOtherType>>>>)
+ constexpr ValuePtr(const ValuePtr<TOtherType, TStorage>& other) noexcept(
+     kNothrowConstruct<std::add_const_t<
+         std::add_lvalue_reference_t<std::remove_cvref_t<TOtherType>>>>)
    requires(!std::same_as<std::remove_cvref_t<TOtherType>, TValueType> &&
             std::is_constructible_v<
                 TValueType, std::add_const_t<std::add_lvalue_reference_t<
                                 std::remove_cvref_t<TOtherType>>>>)
-     : m_ptr{std::make_unique<TValueType>(*other)} {}
+     : m_storage{std::in_place, *other} {}
 
  // COPY ASSIGNMENT FROM VALUE_PTR<OTHER>
 
  template <typename TOtherType>
- constexpr ValuePtr& operator=(const ValuePtr<TOtherType>&)
+ constexpr ValuePtr& operator=(const ValuePtr<TOtherType, TStorage>&)
    requires(!std::same_as<std::remove_cvref_t<TOtherType>, TValueType> &&
             !std::is_assignable_v<TValueType,
                                   std::add_const_t<std::add_lvalue_reference_t<
@@ -118,24 +549,25 @@ public:
  = delete;
 
  template <typename TOtherType>
- constexpr ValuePtr& operator=(const ValuePtr<TOtherType>& other) noexcept(
+ constexpr ValuePtr& operator=(
+     const ValuePtr<TOtherType, TStorage>& other) noexcept(
      std::is_nothrow_assignable_v<TValueType,
                                   std::add_const_t<std::add_lvalue_reference_t<
-                                      std::remove_cvref_t<TOtherType>>>>)
+                                      std::remove_cvref_t<TOtherType>>>> &&
+     kNothrowAssign)
    requires(!std::same_as<std::remove_cvref_t<TOtherType>, TValueType> &&
             std::is_assignable_v<TValueType,
                                  std::add_const_t<std::add_lvalue_reference_t<
                                      std::remove_cvref_t<TOtherType>>>>)
  {
-   // Not sure this is possible
-   if (&other != this) { m_ptr = std::make_unique<TValueType>(*other); }
+   AssignValue(*other);
    return *this;
  }
 
  // MOVE CONSTRUCTION FROM VALUE_PTR<OTHER>
 
  template <typename TOtherType>
- constexpr ValuePtr(ValuePtr<TOtherType>&&)
+ constexpr ValuePtr(ValuePtr<TOtherType, TStorage>&&)
    requires(!std::same_as<std::remove_cvref_t<TOtherType>, TValueType> &&
             !std::is_constructible_v<TValueType,
                                      std::add_rvalue_reference_t<
@@ -143,21 +575,20 @@ public:
  = delete;
 
  template <typename TOtherType>
- constexpr ValuePtr(ValuePtr<TOtherType>&& other) noexcept(
-     std::is_nothrow_constructible_v<
-         TValueType,
+ constexpr ValuePtr(ValuePtr<TOtherType, TStorage>&& other) noexcept(
+     kNothrowConstruct<
          std::add_rvalue_reference_t<std::remove_reference_t<TOtherType>>>)
    requires(
        !std::same_as<std::remove_cvref_t<TOtherType>, TValueType> &&
        std::is_constructible_v<
            TValueType,
            std::add_rvalue_reference_t<std::remove_reference_t<TOtherType>>>)
-     : m_ptr{std::move(other.m_ptr)} {}
+     : m_storage{std::in_place, std::move(*other)} {}
 
  // MOVE ASSIGNMENT FROM VALUE_PTR<OTHER>
 
  template <typename TOtherType>
- constexpr ValuePtr& operator=(ValuePtr<TOtherType>&&)
+ constexpr ValuePtr& operator=(ValuePtr<TOtherType, TStorage>&&)
    requires(!std::same_as<std::remove_cvref_t<TOtherType>, TValueType> &&
             !std::is_assignable_v<TValueType,
                                   std::add_rvalue_reference_t<
@@ -165,17 +596,18 @@ public:
  = delete;
 
  template <typename TOtherType>
- constexpr ValuePtr& operator=(ValuePtr<TOtherType>&& other) noexcept(
+ constexpr ValuePtr& operator=(ValuePtr<TOtherType, TStorage>&& other) noexcept(
      std::is_nothrow_assignable_v<
          TValueType,
-         std::add_rvalue_reference_t<std::remove_reference_t<TOtherType>>>)
+         std::add_rvalue_reference_t<std::remove_reference_t<TOtherType>>> &&
+     kNothrowAssign)
    requires(
        !std::same_as<std::remove_cvref_t<TOtherType>, TValueType> &&
        std::is_assignable_v<
            TValueType,
            std::add_rvalue_reference_t<std::remove_reference_t<TOtherType>>>)
  {
-   m_ptr = std::move(other.m_ptr);
+   AssignValue(std::move(*other));
    return *this;
  }
 
@@ -191,14 +623,13 @@ public:
 
  template <typename TOtherType>
  constexpr ValuePtr(const TOtherType& other) noexcept(
-     std::is_nothrow_constructible_v<
-         TValueType, std::add_const_t<std::add_lvalue_reference_t<
-                         std::remove_cvref_t<TOtherType>>>>)
+     kNothrowConstruct<std::add_const_t<
+         std::add_lvalue_reference_t<std::remove_cvref_t<TOtherType>>>>)
    requires(!IsSpecializationOfV<std::remove_cvref_t<TOtherType>, ValuePtr> &&
             std::is_constructible_v<
                 TValueType, std::add_const_t<std::add_lvalue_reference_t<
                                 std::remove_cvref_t<TOtherType>>>>)
-     : m_ptr{std::make_unique<TValueType>(other)} {}
+     : m_storage{std::in_place, other} {}
 
  // COPY ASSIGNMENT FROM OTHER
 
@@ -214,13 +645,14 @@ public:
  constexpr ValuePtr& operator=(const TOtherType& other) noexcept(
      std::is_nothrow_assignable_v<TValueType,
                                   std::add_const_t<std::add_lvalue_reference_t<
-                                      std::remove_cvref_t<TOtherType>>>>)
+                                      std::remove_cvref_t<TOtherType>>>> &&
+     kNothrowAssign)
    requires(!IsSpecializationOfV<std::remove_cvref_t<TOtherType>, ValuePtr> &&
             std::is_assignable_v<TValueType,
                                  std::add_const_t<std::add_lvalue_reference_t<
                                      std::remove_cvref_t<TOtherType>>>>)
  {
-   *m_ptr = other;
+   AssignValue(other);
    return *this;
  }
 
@@ -239,18 +671,15 @@ public:
  template <typename TOtherType>
  constexpr ValuePtr(
      std::add_rvalue_reference_t<std::remove_reference_t<TOtherType>>
-         other) noexcept(std::
-                             is_nothrow_constructible_v<
-                                 TValueType,
-                                 std::add_rvalue_reference_t<
-                                     std::remove_reference_t<TOtherType>>>)
+         other) noexcept(kNothrowConstruct<std::add_rvalue_reference_t<
+                             std::remove_reference_t<TOtherType>>>)
    requires(
        std::is_rvalue_reference_v<TOtherType> &&
        !IsSpecializationOfV<std::remove_cvref_t<TOtherType>, ValuePtr> &&
        std::is_constructible_v<
            TValueType,
            std::add_rvalue_reference_t<std::remove_reference_t<TOtherType>>>)
-     : m_ptr{std::make_unique<TValueType>(std::move(other))} {}
+     : m_storage{std::in_place, std::move(other)} {}
 
  // MOVE ASSIGNMENT FROM VALUE_PTR<OTHER>
 
@@ -271,7 +700,8 @@ public:
                              is_nothrow_assignable_v<
                                  TValueType,
                                  std::add_rvalue_reference_t<
-                                     std::remove_reference_t<TOtherType>>>)
+                                     std::remove_reference_t<TOtherType>>> &&
+     kNothrowAssign)
    requires(
        std::is_rvalue_reference_v<TOtherType> &&
        !IsSpecializationOfV<std::remove_cvref_t<TOtherType>, ValuePtr> &&
@@ -279,28 +709,66 @@ public:
            TValueType,
            std::add_rvalue_reference_t<std::remove_reference_t<TOtherType>>>)
  {
-   *m_ptr = std::move(other);
+   AssignValue(std::move(other));
    return *this;
  }
 
- friend constexpr void swap(ValuePtr& lhs, ValuePtr& rhs) noexcept {
-   std::swap(lhs.m_ptr, rhs.m_ptr);
+ friend constexpr void swap(ValuePtr& lhs, ValuePtr& rhs) noexcept(
+     noexcept(lhs.m_storage.Swap(rhs.m_storage))) {
+   lhs.m_storage.Swap(rhs.m_storage);
  }
 
- constexpr const TValueType& operator*() const { return m_ptr.operator*(); }
- constexpr TValueType& operator*() { return m_ptr.operator*(); }
- constexpr const TValueType* operator->() const { return m_ptr.operator->(); }
- constexpr TValueType* operator->() { return m_ptr.operator->(); }
+ constexpr const TValueType& operator*() const { return *m_storage.Get(); }
+ constexpr TValueType& operator*() { return *m_storage.Get(); }
+ constexpr const TValueType* operator->() const { return m_storage.Get(); }
+ constexpr TValueType* operator->() { return m_storage.Get(); }
 
  constexpr ~ValuePtr() = default;
 
 private:
- std::unique_ptr<TValueType> m_ptr{nullptr};
+ // Asked of the holder rather than TValueType: every storage but
+ // InlineStorage allocates to build a value
+ template <typename... TArgs>
+ static constexpr bool kNothrowConstruct =
+     std::is_nothrow_constructible_v<Holder, std::in_place_t, TArgs...>;
+
+ // Only inline values are always engaged; the others may have to allocate
+ static constexpr bool kNothrowAssign = Holder::kInline;
+
+ // Assigns through the held value, or builds a new one when a moved-from
+ // ValuePtr has none
+ template <typename TArg>
+ constexpr void AssignValue(TArg&& arg) {
+   if constexpr (!Holder::kInline &&
+                 std::is_constructible_v<TValueType, TArg&&>) {
+     if (std::as_const(m_storage).Get() == nullptr) {
+       m_storage.Emplace(std::forward<TArg>(arg));
+       return;
+     }
+   }
+   *m_storage.Get() = std::forward<TArg>(arg);
+ }
+
+ Holder m_storage;
 };
 
-template <typename TValueType, typename... TArgs>
-ValuePtr<TValueType> MakeValuePtr(TArgs&&... args) {
- return ValuePtr<TValueType>(TValueType(std::forward<TArgs>(args)...));
+template <typename TValueType, typename TStorage = HeapStorage,
+         typename... TArgs>
+ValuePtr<TValueType, TStorage> MakeValuePtr(TArgs&&... args) {
+ return ValuePtr<TValueType, TStorage>(std::in_place,
+                                       std::forward<TArgs>(args)...);
+}
+
+/**
+ * @brief Construct a ValuePtr in memory obtained from alloc, in the manner of
+ * std::allocate_shared
+ */
+template <typename TValueType, typename TAllocator, typename... TArgs>
+auto AllocateValuePtr(const TAllocator& alloc, TArgs&&... args) {
+ using Storage = AllocatorStorage<typename std::allocator_traits<
+     TAllocator>::template rebind_alloc<std::byte>>;
+ return ValuePtr<TValueType, Storage>(std::allocator_arg, alloc,
+                                      std::forward<TArgs>(args)...);
 }
 
 }  // namespace mguid
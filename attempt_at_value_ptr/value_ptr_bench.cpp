@@ -0,0 +1,887 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "polymorphic_value_ptr.hpp"
+#include "value_ptr.hpp"
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+ g_allocations.fetch_add(1, std::memory_order_relaxed);
+ if (void* ptr = std::malloc(size == 0 ? 1 : size)) { return ptr; }
+ throw std::bad_alloc{};
+}
+
+// memory_resource upstreams allocate through the aligned overloads
+void* operator new(std::size_t size, std::align_val_t align) {
+ g_allocations.fetch_add(1, std::memory_order_relaxed);
+ const auto alignment = static_cast<std::size_t>(align);
+ const auto rounded =
+     std::max((size + alignment - 1) / alignment * alignment, alignment);
+ if (void* ptr = std::aligned_alloc(alignment, rounded)) {
+   return ptr;
+ }
+ throw std::bad_alloc{};
+}
+
+// GCC pairs the free below with the new-expression it was inlined into
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+ std::free(ptr);
+}
+#pragma GCC diagnostic pop
+
+namespace {
+
+using mguid::AtomicRefCount;
+using mguid::CopyOnWrite;
+using mguid::HeapStorage;
+using mguid::InlineStorage;
+using mguid::MakeValuePtr;
+using mguid::NonAtomicRefCount;
+using mguid::PmrStorage;
+using mguid::PolymorphicValuePtr;
+using mguid::ValuePtr;
+
+// Keeps the optimizer from discarding the work being measured
+volatile std::uint64_t g_sink{0};
+
+struct Small {
+ std::uint64_t a{1};
+ std::uint64_t b{2};
+
+ bool operator<(const Small& other) const { return a < other.a; }
+};
+
+struct Medium {
+ std::array<std::uint64_t, 8> words{};
+
+ bool operator<(const Medium& other) const {
+   return words[0] < other.words[0];
+ }
+};
+
+struct Large {
+ std::array<std::uint64_t, 32> words{};
+
+ bool operator<(const Large& other) const { return words[0] < other.words[0]; }
+};
+
+template <typename TValueType>
+TValueType make_value(std::size_t idx) {
+ if constexpr (std::is_same_v<TValueType, Small>) {
+   return Small{idx * 2654435761u % 1000003, idx};
+ } else if constexpr (std::is_same_v<TValueType, Medium>) {
+   Medium medium{};
+   medium.words[0] = idx * 2654435761u % 1000003;
+   return medium;
+ } else if constexpr (std::is_same_v<TValueType, Large>) {
+   Large large{};
+   large.words[0] = idx * 2654435761u % 1000003;
+   return large;
+ } else {
+   return std::to_string(idx * 2654435761u % 1000003);
+ }
+}
+
+template <typename TValueType>
+std::uint64_t first_word(const TValueType& value) {
+ if constexpr (std::is_same_v<TValueType, Small>) {
+   return value.a;
+ } else if constexpr (std::is_same_v<TValueType, Medium> ||
+                      std::is_same_v<TValueType, Large>) {
+   return value.words[0];
+ } else {
+   return value.size();
+ }
+}
+
+// std::unique_ptr plus the copy operations people write by hand to give it
+// value semantics. Default constructed it is empty, like unique_ptr; a
+// ValuePtr always holds a value.
+template <typename TValueType>
+class UniqueClonePtr {
+public:
+ UniqueClonePtr() = default;
+
+ explicit UniqueClonePtr(const TValueType& value)
+     : m_ptr{std::make_unique<TValueType>(value)} {}
+
+ template <typename... TArgs>
+ explicit UniqueClonePtr(std::in_place_t, TArgs&&... args)
+     : m_ptr{std::make_unique<TValueType>(std::forward<TArgs>(args)...)} {}
+
+ UniqueClonePtr(const UniqueClonePtr& other)
+     : m_ptr{other.m_ptr ? std::make_unique<TValueType>(*other.m_ptr)
+                         : nullptr} {}
+
+ UniqueClonePtr(UniqueClonePtr&&) noexcept = default;
+
+ // Reuses the existing allocation when there is one, which ValuePtr doesn't
+ UniqueClonePtr& operator=(const UniqueClonePtr& other) {
+   if (this == &other) { return *this; }
+   if (m_ptr && other.m_ptr) {
+     *m_ptr = *other.m_ptr;
+   } else {
+     m_ptr = other.m_ptr ? std::make_unique<TValueType>(*other.m_ptr)
+                         : nullptr;
+   }
+   return *this;
+ }
+
+ UniqueClonePtr& operator=(UniqueClonePtr&&) noexcept = default;
+
+ friend void swap(UniqueClonePtr& lhs, UniqueClonePtr& rhs) noexcept {
+   lhs.m_ptr.swap(rhs.m_ptr);
+ }
+
+ const TValueType& operator*() const { return *m_ptr; }
+ TValueType& operator*() { return *m_ptr; }
+ const TValueType* operator->() const { return m_ptr.get(); }
+ TValueType* operator->() { return m_ptr.get(); }
+
+private:
+ std::unique_ptr<TValueType> m_ptr;
+};
+
+// Plain values are the baseline the other holders are compared against
+template <typename THolder>
+decltype(auto) deref(const THolder& holder) {
+ if constexpr (mguid::IsSpecializationOfV<THolder, ValuePtr> ||
+               mguid::IsSpecializationOfV<THolder, UniqueClonePtr> ||
+               mguid::IsSpecializationOfV<THolder, std::optional>) {
+   return *holder;
+ } else {
+   return (holder);
+ }
+}
+
+struct Result {
+ double ns_per_elem;
+ double allocs_per_elem;
+};
+
+template <typename TFunc>
+Result measure(std::size_t elems, TFunc&& func) {
+ const auto allocs_before = g_allocations.load(std::memory_order_relaxed);
+ const auto start = std::chrono::steady_clock::now();
+ func();
+ const auto stop = std::chrono::steady_clock::now();
+ const auto allocs =
+     g_allocations.load(std::memory_order_relaxed) - allocs_before;
+ return {std::chrono::duration<double, std::nano>(stop - start).count() /
+             static_cast<double>(elems),
+         static_cast<double>(allocs) / static_cast<double>(elems)};
+}
+
+void print(const char* label, const Result& result) {
+ std::cout << '\t' << label << ' ' << result.ns_per_elem << " ns, "
+           << result.allocs_per_elem << " allocs";
+}
+
+// Fill a vector of holders without reserving, so growth moves every element
+// a few times, copy it, then sort the copy
+template <typename THolder, typename TValueType>
+void copy_sort_row(const char* label, std::size_t elems) {
+ std::vector<THolder> source;
+ const auto push_result = measure(elems, [&] {
+   for (std::size_t idx{0}; idx < elems; ++idx) {
+     source.emplace_back(make_value<TValueType>(idx));
+   }
+ });
+
+ std::vector<THolder> copy;
+ const auto copy_result = measure(elems, [&] { copy = source; });
+ const auto sort_result = measure(elems, [&] {
+   std::sort(copy.begin(), copy.end(), [](const auto& lhs, const auto& rhs) {
+     return deref(lhs) < deref(rhs);
+   });
+ });
+ const auto read_result = measure(elems, [&] {
+   std::uint64_t sum{0};
+   for (const auto& holder : copy) { sum += first_word(deref(holder)); }
+   g_sink = g_sink + sum;
+ });
+ const auto destroy_result = measure(elems, [&] {
+   copy.clear();
+   copy.shrink_to_fit();
+ });
+
+ std::cout << label;
+ print("push", push_result);
+ print("copy", copy_result);
+ print("sort", sort_result);
+ print("read", read_result);
+ print("destroy", destroy_result);
+ std::cout << '\n';
+}
+
+// Calls row(std::type_identity<THolder>{}, label) for the plain value and
+// for every holder of it being compared
+template <typename TValueType, typename TRow>
+void for_each_holder(TRow&& row) {
+ using Inline = ValuePtr<TValueType, InlineStorage<>>;
+ row(std::type_identity<TValueType>{}, "plain           ");
+ row(std::type_identity<std::optional<TValueType>>{}, "optional        ");
+ row(std::type_identity<UniqueClonePtr<TValueType>>{}, "unique_ptr+clone");
+ row(std::type_identity<ValuePtr<TValueType, HeapStorage>>{},
+     "heap            ");
+ row(std::type_identity<Inline>{},
+     Inline::kStoresInline ? "inline          " : "inline(heap)    ");
+}
+
+template <typename TValueType>
+void bench_copy_sort(const char* type_name) {
+ const std::size_t elems{1'000'000};
+ std::cout << "vector of 1M " << type_name << " (per element)\n";
+ for_each_holder<TValueType>([elems](auto holder, const char* label) {
+   copy_sort_row<typename decltype(holder)::type, TValueType>(label, elems);
+ });
+}
+
+inline constexpr std::size_t kBatch{1024};
+
+// Uninitialized room for kBatch holders, so construction can be timed apart
+// from destroying what was there before
+template <typename THolder>
+class Slots {
+public:
+ Slots() : m_holders{std::allocator<THolder>{}.allocate(kBatch)} {}
+ Slots(const Slots&) = delete;
+ Slots& operator=(const Slots&) = delete;
+ ~Slots() {
+   Destroy();
+   std::allocator<THolder>{}.deallocate(m_holders, kBatch);
+ }
+
+ // Destroys the last batch; the next one has to construct every slot
+ void Recycle() {
+   Destroy();
+   m_full = true;
+ }
+
+ template <typename... TArgs>
+ void Construct(std::size_t idx, TArgs&&... args) {
+   std::construct_at(m_holders + idx, std::forward<TArgs>(args)...);
+ }
+
+private:
+ void Destroy() {
+   if (m_full) { std::destroy_n(m_holders, kBatch); }
+   m_full = false;
+ }
+
+ THolder* m_holders;
+ bool m_full{false};
+};
+
+// Times op(idx) over batches of kBatch indices. reset() runs untimed before
+// each batch to put back whatever the last one used up.
+template <typename TReset, typename TOp>
+Result per_op(std::size_t batches, TReset&& reset, TOp&& op) {
+ std::chrono::steady_clock::duration elapsed{};
+ std::uint64_t allocs{0};
+ for (std::size_t batch{0}; batch < batches; ++batch) {
+   reset();
+   const auto allocs_before = g_allocations.load(std::memory_order_relaxed);
+   const auto start = std::chrono::steady_clock::now();
+   for (std::size_t idx{0}; idx < kBatch; ++idx) { op(idx); }
+   elapsed += std::chrono::steady_clock::now() - start;
+   allocs += g_allocations.load(std::memory_order_relaxed) - allocs_before;
+ }
+ const auto ops = static_cast<double>(batches * kBatch);
+ return {std::chrono::duration<double, std::nano>(elapsed).count() / ops,
+         static_cast<double>(allocs) / ops};
+}
+
+template <typename THolder, typename TValueType>
+void operations_row(const char* label, std::size_t batches) {
+ std::vector<THolder> pool;
+ for (std::size_t idx{0}; idx < kBatch; ++idx) {
+   pool.emplace_back(make_value<TValueType>(idx));
+ }
+ std::vector<THolder> sources;
+ std::vector<THolder> targets;
+ Slots<THolder> slots;
+ const auto recycle = [&] { slots.Recycle(); };
+ const auto no_reset = [] {};
+
+ const auto default_result =
+     per_op(batches, recycle, [&](std::size_t idx) { slots.Construct(idx); });
+ const auto copy_result = per_op(batches, recycle, [&](std::size_t idx) {
+   slots.Construct(idx, std::as_const(pool[idx]));
+ });
+ const auto move_result = per_op(
+     batches,
+     [&] {
+       slots.Recycle();
+       sources = pool;
+     },
+     [&](std::size_t idx) { slots.Construct(idx, std::move(sources[idx])); });
+ const auto copy_assign_result = per_op(
+     batches, [&] { targets = pool; },
+     [&](std::size_t idx) { targets[idx] = pool[kBatch - 1 - idx]; });
+ const auto move_assign_result = per_op(
+     batches,
+     [&] {
+       targets = pool;
+       sources = pool;
+     },
+     [&](std::size_t idx) { targets[idx] = std::move(sources[idx]); });
+ const auto swap_result = per_op(batches, no_reset, [&](std::size_t idx) {
+   using std::swap;
+   swap(pool[idx], pool[kBatch - 1 - idx]);
+ });
+ std::uint64_t sum{0};
+ const auto deref_result = per_op(batches, no_reset, [&](std::size_t idx) {
+   sum += first_word(deref(pool[idx]));
+ });
+ g_sink = g_sink + sum;
+
+ std::cout << label;
+ print("default", default_result);
+ print("copy", copy_result);
+ print("move", move_result);
+ print("copy=", copy_assign_result);
+ print("move=", move_assign_result);
+ print("swap", swap_result);
+ print("deref", deref_result);
+ std::cout << '\n';
+}
+
+// Constructions don't include destroying anything; assignments include
+// releasing the value they overwrite
+template <typename TValueType>
+void bench_operations(const char* type_name) {
+ const std::size_t batches{2'000};
+ std::cout << type_name << " (per operation)\n";
+ for_each_holder<TValueType>([batches](auto holder, const char* label) {
+   operations_row<typename decltype(holder)::type, TValueType>(label,
+                                                               batches);
+ });
+}
+
+// A pimpl-style object copied around whole, as in a message passed by value
+template <typename TStorage>
+struct Message {
+ ValuePtr<Small, TStorage> header;
+ ValuePtr<std::string, TStorage> topic;
+ ValuePtr<Large, TStorage> body;
+};
+
+template <typename TStorage>
+Result message_copies(std::size_t iters) {
+ Message<TStorage> message{Small{}, std::string{"sensors/temperature"},
+                           Large{}};
+ return measure(iters, [&] {
+   for (std::size_t idx{0}; idx < iters; ++idx) {
+     auto copy = message;
+     copy.header->a = idx;
+     g_sink = g_sink + copy.header->a + copy.topic->size() +
+              copy.body->words[0];
+   }
+ });
+}
+
+void bench_message_copies() {
+ constexpr std::size_t iters{2'000'000};
+ std::cout << "copy a {Small, string, Large} message (per copy)\n";
+ std::cout << "heap  ";
+ print("", message_copies<HeapStorage>(iters));
+ std::cout << "\ninline";
+ print("", message_copies<InlineStorage<>>(iters));
+ std::cout << '\n';
+}
+
+// Large, mostly read configuration object
+struct Config {
+ std::vector<std::string> entries;
+ std::uint64_t revision{0};
+};
+
+Config make_config() {
+ Config config;
+ for (std::size_t idx{0}; idx < 64; ++idx) {
+   config.entries.push_back("option." + std::to_string(idx) + " = some value");
+ }
+ return config;
+}
+
+// Every iteration copies the config; one in write_every copies is modified
+template <typename TStorage>
+Result config_copies(std::size_t iters, std::size_t write_every) {
+ const ValuePtr<Config, TStorage> original{make_config()};
+ return measure(iters, [&] {
+   for (std::size_t idx{0}; idx < iters; ++idx) {
+     auto copy = original;
+     if (write_every != 0 && idx % write_every == 0) {
+       copy->revision = idx;
+     }
+     const auto& view = std::as_const(copy);
+     g_sink = g_sink + view->revision + view->entries[idx % 64].size();
+   }
+ });
+}
+
+// Comparing CopyOnWrite with deep copying only means something while its
+// copies still behave as values: writes through one copy, by assignment or
+// through a reference handed out earlier, never show through another
+template <typename TStorage>
+bool copies_behave_as_values() {
+ const ValuePtr<Config, TStorage> original{make_config()};
+ auto written = original;
+ auto assigned = original;
+ assigned = written;
+ written->revision = 1;
+ auto& held = *assigned;
+ const auto copied = assigned;
+ held.revision = 2;
+ held.entries.pop_back();
+ return original->revision == 0 && original->entries.size() == 64 &&
+        std::as_const(written)->revision == 1 &&
+        std::as_const(written)->entries.size() == 64 &&
+        copied->revision == 0 && copied->entries.size() == 64 &&
+        std::as_const(assigned)->revision == 2 &&
+        std::as_const(assigned)->entries.size() == 63;
+}
+
+void bench_copy_on_write() {
+ constexpr std::size_t iters{200'000};
+ std::cout << "copy a 64-entry config, then read or write it (per copy)\n";
+ for (const std::size_t write_every : {0u, 100u, 10u, 1u}) {
+   std::cout << (write_every == 0 ? std::string{"read only"}
+                                  : "write 1/" + std::to_string(write_every));
+   print("deep", config_copies<HeapStorage>(iters, write_every));
+   print("cow", config_copies<CopyOnWrite<AtomicRefCount>>(iters, write_every));
+   print("cow non-atomic",
+         config_copies<CopyOnWrite<NonAtomicRefCount>>(iters, write_every));
+   std::cout << '\n';
+ }
+}
+
+void bench_make_in_place() {
+ constexpr std::size_t iters{2'000'000};
+ std::cout << "construct a ValuePtr<Large> (per construction)\n";
+ std::cout << "temporary + move";
+ print("", measure(iters, [&] {
+   for (std::size_t idx{0}; idx < iters; ++idx) {
+     ValuePtr<Large> ptr{Large{}};
+     g_sink = g_sink + ptr->words[idx % 32];
+   }
+ }));
+ std::cout << "\nin place        ";
+ print("", measure(iters, [&] {
+   for (std::size_t idx{0}; idx < iters; ++idx) {
+     auto ptr = MakeValuePtr<Large>();
+     g_sink = g_sink + ptr->words[idx % 32];
+   }
+ }));
+ std::cout << '\n';
+}
+
+// Node of a 4-ary tree whose children are held by ValuePtr
+template <typename TStorage>
+struct TreeNode {
+ using Child = ValuePtr<TreeNode, TStorage>;
+ using Children =
+     std::conditional_t<std::is_same_v<TStorage, PmrStorage>,
+                        std::pmr::vector<Child>, std::vector<Child>>;
+
+ std::uint64_t value{0};
+ Children children;
+};
+
+// Builds a tree of exactly `nodes` nodes, spreading them evenly over children
+template <typename TStorage, typename TMakeNode>
+ValuePtr<TreeNode<TStorage>, TStorage> build_tree(std::size_t nodes,
+                                                 std::uint64_t& next,
+                                                 TMakeNode& make_node) {
+ auto node = make_node(next++);
+ std::size_t remaining = nodes - 1;
+ constexpr std::size_t kFanOut{4};
+ node->children.reserve(std::min(remaining, kFanOut));
+ for (std::size_t child{0}; child < kFanOut && remaining > 0; ++child) {
+   const std::size_t slots = kFanOut - child;
+   const std::size_t share = (remaining + slots - 1) / slots;
+   node->children.push_back(build_tree<TStorage>(share, next, make_node));
+   remaining -= share;
+ }
+ return node;
+}
+
+template <typename TNode>
+std::uint64_t walk_tree(const TNode& node) {
+ std::uint64_t sum{node.value};
+ for (const auto& child : node.children) { sum += walk_tree(*child); }
+ return sum;
+}
+
+template <typename TStorage, typename TMakeNode, typename TRelease>
+void tree_row(const char* label, std::size_t nodes, TMakeNode make_node,
+             TRelease release) {
+ std::uint64_t next{0};
+ std::optional<ValuePtr<TreeNode<TStorage>, TStorage>> root;
+ const auto build = measure(nodes, [&] {
+   root.emplace(build_tree<TStorage>(nodes, next, make_node));
+ });
+ const auto walk = measure(nodes, [&] { g_sink = g_sink + walk_tree(**root); });
+ const auto teardown = measure(nodes, [&] {
+   root.reset();
+   release();
+ });
+ std::cout << label;
+ print("build", build);
+ print("walk", walk);
+ print("teardown", teardown);
+ std::cout << '\n';
+}
+
+void bench_arena_tree(std::size_t nodes) {
+ std::cout << "build, walk and free a " << nodes
+           << "-node 4-ary tree (per node)\n";
+
+ tree_row<HeapStorage>(
+     "heap      ", nodes,
+     [](std::uint64_t value) {
+       return MakeValuePtr<TreeNode<HeapStorage>>(value);
+     },
+     [] {});
+
+ std::pmr::unsynchronized_pool_resource pool;
+ tree_row<PmrStorage>(
+     "pmr pool  ", nodes,
+     [&pool](std::uint64_t value) {
+       return ValuePtr<TreeNode<PmrStorage>, PmrStorage>(
+           std::allocator_arg, &pool, value,
+           TreeNode<PmrStorage>::Children(&pool));
+     },
+     [&pool] { pool.release(); });
+
+ // Deallocation is a no-op; everything goes back in the single release()
+ std::pmr::monotonic_buffer_resource arena;
+ tree_row<PmrStorage>(
+     "pmr arena ", nodes,
+     [&arena](std::uint64_t value) {
+       return ValuePtr<TreeNode<PmrStorage>, PmrStorage>(
+           std::allocator_arg, &arena, value,
+           TreeNode<PmrStorage>::Children(&arena));
+     },
+     [&arena] { arena.release(); });
+}
+
+template <typename TValueType>
+using Unboxed = TValueType;
+template <typename TValueType>
+using HeapBox = ValuePtr<TValueType, HeapStorage>;
+template <typename TValueType>
+using InlineBox = ValuePtr<TValueType, InlineStorage<>>;
+
+// A JSON value whose arrays and objects are held by TBox. Recursive types are
+// where ValuePtr is needed: a variant can't hold the incomplete Json, but a
+// vector of it can, so the Unboxed form is the baseline.
+template <template <typename> class TBox>
+struct Json {
+ using Array = std::vector<Json>;
+ using Object = std::vector<std::pair<std::string, Json>>;
+
+ std::variant<std::nullptr_t, bool, double, std::string, TBox<Array>,
+              TBox<Object>>
+     value;
+};
+
+template <typename TBoxed, typename TValueType>
+TBoxed box(TValueType&& value) {
+ if constexpr (std::is_same_v<TBoxed, std::remove_cvref_t<TValueType>>) {
+   return std::forward<TValueType>(value);
+ } else {
+   return TBoxed{std::in_place, std::forward<TValueType>(value)};
+ }
+}
+
+template <typename TValueType>
+const TValueType& unbox(const TValueType& value) {
+ return value;
+}
+
+template <typename TValueType, typename TStorage>
+const TValueType& unbox(const ValuePtr<TValueType, TStorage>& ptr) {
+ return *ptr;
+}
+
+template <typename TValueType>
+const TValueType& unbox(const UniqueClonePtr<TValueType>& ptr) {
+ return *ptr;
+}
+
+// Builds `objects` nested objects, each like
+// {"id": 7, "name": "node-7", "active": false, "scores": [1.75, 2, 2.25],
+//  "children": [...]}, spread evenly over up to four children
+template <template <typename> class TBox>
+Json<TBox> make_document(std::size_t objects, std::uint64_t& next) {
+ using Doc = Json<TBox>;
+ using Array = typename Doc::Array;
+ using Object = typename Doc::Object;
+
+ const std::uint64_t id{next++};
+ Array scores;
+ scores.reserve(3);
+ for (std::uint64_t offset{0}; offset < 3; ++offset) {
+   scores.push_back(Doc{static_cast<double>(id + offset) / 4});
+ }
+
+ std::size_t remaining = objects - 1;
+ constexpr std::size_t kFanOut{4};
+ Array children;
+ children.reserve(std::min(remaining, kFanOut));
+ for (std::size_t child{0}; child < kFanOut && remaining > 0; ++child) {
+   const std::size_t slots = kFanOut - child;
+   const std::size_t share = (remaining + slots - 1) / slots;
+   children.push_back(make_document<TBox>(share, next));
+   remaining -= share;
+ }
+
+ Object object;
+ object.reserve(5);
+ object.emplace_back("id", Doc{static_cast<double>(id)});
+ object.emplace_back("name", Doc{"node-" + std::to_string(id)});
+ object.emplace_back("active", Doc{id % 2 == 0});
+ object.emplace_back("scores", Doc{box<TBox<Array>>(std::move(scores))});
+ object.emplace_back("children", Doc{box<TBox<Array>>(std::move(children))});
+ return Doc{box<TBox<Object>>(std::move(object))};
+}
+
+template <template <typename> class TBox>
+std::uint64_t walk_document(const Json<TBox>& doc) {
+ return std::visit(
+     [](const auto& value) -> std::uint64_t {
+       using Value = std::remove_cvref_t<decltype(value)>;
+       if constexpr (std::is_same_v<Value, std::nullptr_t>) {
+         return 0;
+       } else if constexpr (std::is_same_v<Value, bool>) {
+         return value ? 1 : 0;
+       } else if constexpr (std::is_same_v<Value, double>) {
+         return static_cast<std::uint64_t>(value);
+       } else if constexpr (std::is_same_v<Value, std::string>) {
+         return value.size();
+       } else {
+         std::uint64_t sum{0};
+         for (const auto& element : unbox(value)) {
+           if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>,
+                                        Json<TBox>>) {
+             sum += walk_document(element);
+           } else {
+             sum += element.first.size() + walk_document(element.second);
+           }
+         }
+         return sum;
+       }
+     },
+     doc.value);
+}
+
+template <template <typename> class TBox>
+void json_row(const char* label, std::size_t objects) {
+ std::uint64_t next{0};
+ std::optional<Json<TBox>> doc;
+ const auto build = measure(objects, [&] {
+   doc.emplace(make_document<TBox>(objects, next));
+ });
+ std::optional<Json<TBox>> copy;
+ const auto copy_result = measure(objects, [&] { copy.emplace(*doc); });
+ const auto walk =
+     measure(objects, [&] { g_sink = g_sink + walk_document(*copy); });
+ const auto destroy = measure(objects, [&] { copy.reset(); });
+ std::cout << label;
+ print("build", build);
+ print("copy", copy_result);
+ print("walk", walk);
+ print("destroy", destroy);
+ std::cout << '\n';
+}
+
+// Runs func in a forked child with a fresh heap. How earlier rows left the
+// heap otherwise moves the JSON numbers by 2x or more, depending on order.
+template <typename TFunc>
+void in_child(TFunc&& func) {
+ std::cout.flush();
+ const pid_t child = fork();
+ if (child == 0) {
+   func();
+   std::cout.flush();
+   _exit(0);
+ }
+ waitpid(child, nullptr, 0);
+}
+
+void bench_json(std::size_t objects) {
+ std::cout << "build, deep copy, walk and free a JSON document of " << objects
+           << " objects (per object)\n";
+ in_child([&] { json_row<Unboxed>("vector          ", objects); });
+ in_child([&] { json_row<UniqueClonePtr>("unique_ptr+clone", objects); });
+ in_child([&] { json_row<HeapBox>("heap            ", objects); });
+ in_child([&] {
+   json_row<InlineBox>(InlineBox<Json<InlineBox>::Array>::kStoresInline
+                           ? "inline          "
+                           : "inline(heap)    ",
+                       objects);
+ });
+}
+
+// Hierarchy with the usual virtual Clone, so both idioms can be compared on
+// the same types
+struct Shape {
+ virtual ~Shape() = default;
+ [[nodiscard]] virtual double Area() const = 0;
+ [[nodiscard]] virtual std::unique_ptr<Shape> Clone() const = 0;
+};
+
+struct Circle final : Shape {
+ explicit Circle(double r) : radius{r} {}
+ [[nodiscard]] double Area() const override {
+   return 3.14159 * radius * radius;
+ }
+ [[nodiscard]] std::unique_ptr<Shape> Clone() const override {
+   return std::make_unique<Circle>(*this);
+ }
+
+ double radius;
+};
+
+struct Rect final : Shape {
+ Rect(double w, double h) : width{w}, height{h} {}
+ [[nodiscard]] double Area() const override { return width * height; }
+ [[nodiscard]] std::unique_ptr<Shape> Clone() const override {
+   return std::make_unique<Rect>(*this);
+ }
+
+ double width;
+ double height;
+};
+
+struct Polygon final : Shape {
+ explicit Polygon(std::size_t sides) : lengths(sides, 1.0) {}
+ [[nodiscard]] double Area() const override {
+   return static_cast<double>(lengths.size());
+ }
+ [[nodiscard]] std::unique_ptr<Shape> Clone() const override {
+   return std::make_unique<Polygon>(*this);
+ }
+
+ std::vector<double> lengths;
+};
+
+struct CloningPtr {
+ explicit CloningPtr(std::unique_ptr<Shape> shape) : ptr{std::move(shape)} {}
+ CloningPtr(const CloningPtr& other) : ptr{other.ptr->Clone()} {}
+ CloningPtr(CloningPtr&&) noexcept = default;
+ CloningPtr& operator=(const CloningPtr& other) {
+   ptr = other.ptr->Clone();
+   return *this;
+ }
+ CloningPtr& operator=(CloningPtr&&) noexcept = default;
+
+ const Shape* operator->() const { return ptr.get(); }
+
+ std::unique_ptr<Shape> ptr;
+};
+
+template <typename THolder, typename TMake>
+void shapes_row(const char* label, std::size_t elems, TMake make) {
+ std::vector<THolder> source;
+ source.reserve(elems);
+ for (std::size_t idx{0}; idx < elems; ++idx) {
+   switch (idx % 8) {
+     case 0: source.push_back(make(Polygon{6})); break;
+     case 1:
+     case 2:
+     case 3: source.push_back(make(Rect{1.0, static_cast<double>(idx)})); break;
+     default: source.push_back(make(Circle{static_cast<double>(idx)})); break;
+   }
+ }
+
+ std::vector<THolder> copy;
+ const auto copy_result = measure(elems, [&] { copy = source; });
+ const auto area_result = measure(elems, [&] {
+   double total{0};
+   for (const auto& shape : copy) { total += shape->Area(); }
+   g_sink = g_sink + static_cast<std::uint64_t>(total);
+ });
+ const auto destroy_result = measure(elems, [&] {
+   copy.clear();
+   copy.shrink_to_fit();
+ });
+ std::cout << label;
+ print("copy", copy_result);
+ print("area", area_result);
+ print("destroy", destroy_result);
+ std::cout << '\n';
+}
+
+void bench_polymorphic_copies() {
+ constexpr std::size_t elems{1'000'000};
+ std::cout << "vector of 1M mixed shapes (per element)\n";
+ shapes_row<CloningPtr>("unique_ptr + Clone ", elems, [](auto shape) {
+   return CloningPtr{std::make_unique<decltype(shape)>(std::move(shape))};
+ });
+ // Too small for any shape, so every object is on the heap
+ shapes_row<PolymorphicValuePtr<Shape, sizeof(void*)>>(
+     "polymorphic (heap) ", elems, [](auto shape) {
+       return PolymorphicValuePtr<Shape, sizeof(void*)>{std::move(shape)};
+     });
+ shapes_row<PolymorphicValuePtr<Shape>>(
+     "polymorphic (SBO)  ", elems,
+     [](auto shape) { return PolymorphicValuePtr<Shape>{std::move(shape)}; });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+ if (!copies_behave_as_values<HeapStorage>() ||
+     !copies_behave_as_values<CopyOnWrite<AtomicRefCount>>() ||
+     !copies_behave_as_values<CopyOnWrite<NonAtomicRefCount>>()) {
+   std::cerr << "ValuePtr copies did not behave as values\n";
+   return 1;
+ }
+ std::cout << "sizeof: heap " << sizeof(ValuePtr<Small>) << ", inline "
+           << sizeof(ValuePtr<Small, InlineStorage<>>) << '\n';
+ bench_operations<Small>("Small (16 B)");
+ bench_operations<Medium>("Medium (64 B)");
+ bench_operations<Large>("Large (256 B)");
+ bench_operations<std::string>("std::string");
+ bench_copy_sort<Small>("Small (16 B)");
+ bench_copy_sort<Medium>("Medium (64 B)");
+ bench_copy_sort<std::string>("std::string");
+ bench_copy_sort<Large>("Large (256 B)");
+ bench_message_copies();
+ bench_copy_on_write();
+ bench_make_in_place();
+ bench_polymorphic_copies();
+ bench_json(200'000);
+ bench_arena_tree(argc > 1 ? std::stoul(argv[1]) : 10'000'000);
+}
@@ -0,0 +1,606 @@
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+/**
+ * Generates one file per subject, formulation and instance count, each
+ * instantiating the subject that many times with distinct types, and
+ * compiles it. Reports wall time and the compiler's peak RSS, optionally
+ * checks them against an earlier run, and with --trace keeps the sources
+ * along with clang's -ftime-trace or g++'s -ftime-report for each.
+ *
+ * Every subject has the formulation the repo uses now and, where one
+ * exists, the cheapest equivalent one found so far.
+ */
+
+struct Variant {
+  std::string_view name;
+  // Written once per file
+  std::string_view prelude;
+  // Written once per instance, with every @ replaced by the instance index
+  std::string_view instance;
+};
+
+struct Subject {
+  std::string_view name;
+  // Relative to the repository root, passed with -I
+  std::string_view include_dir;
+  std::vector<Variant> variants;
+};
+
+// generic_closure_traits and is_const_rvalue_reference as they are in
+// constrained_generic_lambda_param/source.cpp
+constexpr std::string_view kClosureTraits = R"(#include <concepts>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+template <typename T>
+concept is_const_rvalue_reference = std::is_rvalue_reference_v<T> &&
+                                    std::is_const_v<std::remove_reference_t<T>>;
+
+template <typename...>
+struct generic_closure_traits;
+
+template <typename TClassType, typename TReturnType, typename... TArgs>
+struct generic_closure_traits<TReturnType (TClassType::*)(TArgs...) const> {
+  static constexpr auto argc = sizeof...(TArgs);
+
+  using result_type = TReturnType;
+
+  template <std::size_t NIdx>
+  using argt = std::tuple_element_t<NIdx, std::tuple<TArgs..., void>>;
+};
+
+template <typename TArg, typename TFunc>
+void check(TFunc&& func)
+  requires is_const_rvalue_reference<typename generic_closure_traits<
+               decltype(&std::remove_reference_t<decltype(func)>::template
+                        operator()<TArg>)>::template argt<0>> ||
+           is_const_rvalue_reference<typename generic_closure_traits<
+               decltype(&std::remove_reference_t<decltype(func)>::operator())>::
+                                         template argt<0>>
+{}
+)";
+
+// One partial specialization matched directly on the call operator's type
+constexpr std::string_view kClosureSpecialization = R"(#include <type_traits>
+
+template <typename TMemberFunc>
+inline constexpr bool takes_const_rvalue_v = false;
+
+template <typename TClassType, typename TReturnType, typename TArg,
+          typename... TArgs>
+inline constexpr bool takes_const_rvalue_v<TReturnType (TClassType::*)(
+    const TArg&&, TArgs...) const> = true;
+
+template <typename TArg, typename TFunc>
+void check(TFunc&&)
+  requires takes_const_rvalue_v<decltype(&std::remove_reference_t<
+                                         TFunc>::template operator()<TArg>)> ||
+           takes_const_rvalue_v<decltype(&std::remove_reference_t<
+                                         TFunc>::operator())>
+{}
+)";
+
+constexpr std::string_view kClosureInstance = R"(struct Arg@ {};
+void use@() {
+  check<Arg@>([](const auto&&) {});
+  check<Arg@>([](const Arg@&&) {});
+}
+)";
+
+constexpr std::string_view kSafeArrayInstance = R"(struct Element@ {
+  int value;
+};
+int use@() {
+  SafeArray<Element@, 4> arr{};
+  int sum{0};
+  arr.unsafe([](const auto&& unsafe_api) { unsafe_api[1].value = @; });
+  arr.const_unsafe(
+      [&sum](const auto&& unsafe_api) { sum += unsafe_api[1].value; });
+  return sum;
+}
+)";
+
+constexpr std::string_view kValuePtrInstance = R"(struct Value@ {
+  int a{@};
+  std::string s;
+};
+struct Wider@ {
+  Wider@() = default;
+  Wider@(const Value@& value) : a{value.a} {}
+  int a{0};
+};
+int use@() {
+  mguid::ValuePtr<Value@> a;
+  mguid::ValuePtr<Value@> b{a};
+  b = a;
+  mguid::ValuePtr<Value@> c{std::move(b)};
+  c = std::move(a);
+  mguid::ValuePtr<Wider@> w{c};
+  w = c;
+  mguid::ValuePtr<Value@> d{Value@{}};
+  swap(c, d);
+  return c->a + w->a + d->a;
+}
+)";
+
+// The same operations with std::unique_ptr and explicit clones, as a floor
+constexpr std::string_view kUniquePtrInstance = R"(struct Value@ {
+  int a{@};
+  std::string s;
+};
+struct Wider@ {
+  Wider@() = default;
+  Wider@(const Value@& value) : a{value.a} {}
+  int a{0};
+};
+int use@() {
+  auto a = std::make_unique<Value@>();
+  auto b = std::make_unique<Value@>(*a);
+  *b = *a;
+  auto c = std::move(b);
+  c = std::move(a);
+  auto w = std::make_unique<Wider@>(*c);
+  *w = *c;
+  auto d = std::make_unique<Value@>(Value@{});
+  swap(c, d);
+  return c->a + w->a + d->a;
+}
+)";
+
+// The table popcount/popcount2.cpp used to build: one lambda call per entry,
+// folded over an index_sequence. TTag only forces a fresh instantiation per
+// use.
+constexpr std::string_view kTableFold = R"(#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+template <std::size_t NBitWidth, typename TTag>
+constexpr auto get_bit_count_table() {
+  constexpr auto num_entries = 1ul << NBitWidth;
+
+  constexpr auto popcount = [](std::size_t val) {
+    auto count{0u};
+    for (auto i{0u}; i < NBitWidth; ++i) {
+      count += ((val >> i) & 1);
+    }
+    return count;
+  };
+
+  return [&]<std::size_t... NIdxs>(std::index_sequence<NIdxs...>) {
+    std::array<std::uint_least8_t, num_entries> result;
+    ([&]() { result[NIdxs] = popcount(NIdxs); }(), ...);
+    return result;
+  }(std::make_index_sequence<num_entries>{});
+}
+)";
+
+// The constexpr loop popcount/popcount2.cpp builds it with now
+constexpr std::string_view kTableLoop = R"(#include <array>
+#include <cstddef>
+#include <cstdint>
+
+template <std::size_t NBitWidth, typename TTag>
+constexpr auto get_bit_count_table() {
+  std::array<std::uint_least8_t, (1ul << NBitWidth)> result{};
+  for (std::size_t idx{1}; idx < result.size(); ++idx) {
+    result[idx] = static_cast<std::uint_least8_t>(result[idx >> 1] + (idx & 1));
+  }
+  return result;
+}
+)";
+
+constexpr std::string_view kTable8Instance = R"(struct Tag@ {};
+constexpr auto kTable@ = get_bit_count_table<8, Tag@>();
+int use@(unsigned value) { return kTable@[value & 0xffu]; }
+)";
+
+constexpr std::string_view kTable10Instance = R"(struct Tag@ {};
+constexpr auto kTable@ = get_bit_count_table<10, Tag@>();
+int use@(unsigned value) { return kTable@[value & 0x3ffu]; }
+)";
+
+// The array ops from apply_nonsense.hpp next to the tuple based apply they
+// replace, at several array sizes; tuple_apply is the original
+constexpr std::string_view kApplyPrelude = R"(#include <array>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "apply_nonsense.hpp"
+
+template <typename TArray, std::size_t... TIntSeq>
+constexpr auto array_to_tuple_impl(const TArray& a,
+                                   std::index_sequence<TIntSeq...>) noexcept {
+  return std::make_tuple(a[TIntSeq]...);
+}
+
+template <typename TFunc, typename T, std::size_t N>
+constexpr decltype(auto) tuple_apply(TFunc&& func,
+                                     const std::array<T, N>& arr) {
+  return std::apply(std::forward<TFunc>(func),
+                    array_to_tuple_impl(arr, std::make_index_sequence<N>{}));
+}
+)";
+
+// Each expression sees `arr`, a std::array<int, N>. Every instance has its
+// own lambda and so its own closure type, which makes it a separate
+// instantiation.
+constexpr std::pair<std::string_view, std::string_view> kApplyForms[]{
+    {"tuple apply",
+     "tuple_apply([](auto... v) { return (0 + ... + v); }, arr)"},
+    {"apply", "mguid::apply([](auto... v) { return (0 + ... + v); }, arr)"},
+    {"fold", "mguid::fold(arr, 0, [](int a, int v) { return a + v; })"},
+    {"fold<16>",
+     "mguid::fold<16>(arr, 0, [](int a, int v) { return a + v; })"},
+    {"transform", "mguid::transform(arr, [](int v) { return v + 1; })[0]"},
+    {"transform<16>",
+     "mguid::transform<16>(arr, [](int v) { return v + 1; })[0]"},
+};
+
+// Past 64 the tuple version takes minutes per file, and at 1024 it exceeds
+// the default template depth, so it is only measured up to there
+constexpr std::size_t kApplySizes[]{4, 16, 64, 256, 1024};
+constexpr std::size_t kApplyTupleMax{64};
+
+// Subjects only refer to their text, so the text the apply subjects generate
+// from N is built once and kept for the rest of the run
+std::vector<Subject> apply_subjects() {
+  static const std::vector<std::string> text = [] {
+    std::vector<std::string> text;
+    for (const std::size_t size : kApplySizes) {
+      text.push_back("apply N=" + std::to_string(size));
+      text.push_back(std::string{kApplyPrelude} +
+                     "\nconstexpr std::size_t N = " + std::to_string(size) +
+                     ";\n");
+    }
+    for (const auto& [name, expression] : kApplyForms) {
+      text.push_back("int use@(const std::array<int, N>& arr) {\n  return " +
+                     std::string{expression} + ";\n}\n");
+    }
+    return text;
+  }();
+
+  std::vector<Subject> subjects;
+  const std::string* instances = &text[2 * std::size(kApplySizes)];
+  for (std::size_t idx{0}; idx < std::size(kApplySizes); ++idx) {
+    Subject subject{text[2 * idx], "apply_nonsense", {}};
+    for (std::size_t form{0}; form < std::size(kApplyForms); ++form) {
+      if (form == 0 && kApplySizes[idx] > kApplyTupleMax) {
+        continue;
+      }
+      subject.variants.push_back(
+          {kApplyForms[form].first, text[2 * idx + 1], instances[form]});
+    }
+    subjects.push_back(std::move(subject));
+  }
+  return subjects;
+}
+
+std::vector<Subject> subjects() {
+  auto subjects = apply_subjects();
+  subjects.insert(subjects.begin(), {
+      {"closure check",
+       "",
+       {{"generic_closure_traits", kClosureTraits, kClosureInstance},
+        {"specialization", kClosureSpecialization, kClosureInstance}}},
+      {"SafeArray unsafe",
+       "unsafe_proxy",
+       {{"unsafe_proxy.hpp", "#include \"unsafe_proxy.hpp\"\n",
+         kSafeArrayInstance}}},
+      {"ValuePtr",
+       "attempt_at_value_ptr",
+       {{"value_ptr.hpp",
+         "#include <string>\n#include <utility>\n\n"
+         "#include \"value_ptr.hpp\"\n",
+         kValuePtrInstance},
+        {"unique_ptr",
+         "#include <memory>\n#include <string>\n#include <utility>\n",
+         kUniquePtrInstance}}},
+      {"popcount table<8>",
+       "",
+       {{"index_sequence", kTableFold, kTable8Instance},
+        {"loop", kTableLoop, kTable8Instance}}},
+      {"popcount table<10>",
+       "",
+       {{"index_sequence", kTableFold, kTable10Instance},
+        {"loop", kTableLoop, kTable10Instance}}},
+  });
+  return subjects;
+}
+
+void write_source(const fs::path& path, const Variant& variant,
+                  std::size_t instances) {
+  std::ofstream out{path};
+  out << variant.prelude << '\n';
+  const std::string instance{variant.instance};
+  for (std::size_t idx{0}; idx < instances; ++idx) {
+    for (const char chr : instance) {
+      if (chr == '@') {
+        out << idx;
+      } else {
+        out << chr;
+      }
+    }
+    out << '\n';
+  }
+}
+
+struct CompileCost {
+  bool ok{false};
+  double seconds{0};
+  long peak_kb{0};
+};
+
+struct Compiler {
+  std::string command;
+  std::vector<std::string> flags;
+  bool is_clang{false};
+};
+
+/**
+ * Compiles source in a fresh child. The child forks the compiler driver and
+ * reports getrusage(RUSAGE_CHILDREN) once the driver has exited, which covers
+ * cc1plus too; asking from this process would give the high water mark over
+ * every compile so far instead.
+ *
+ * With a trace path, clang writes its -ftime-trace JSON next to the object
+ * and g++'s -ftime-report goes to the trace path; otherwise diagnostics are
+ * dropped, since the row already says when a compile failed.
+ */
+CompileCost compile(const Compiler& compiler, const fs::path& source,
+                    const fs::path& include_dir, const fs::path& trace) {
+  std::vector<std::string> args{compiler.command, "-std=c++20"};
+  args.insert(args.end(), compiler.flags.begin(), compiler.flags.end());
+  args.push_back("-I" + include_dir.string());
+  args.push_back("-c");
+  args.push_back(source.string());
+  args.push_back("-o");
+  if (trace.empty()) {
+    args.push_back("/dev/null");
+  } else {
+    args.push_back(fs::path{trace}.replace_extension(".o").string());
+    args.push_back(compiler.is_clang ? "-ftime-trace" : "-ftime-report");
+  }
+  std::vector<char*> argv;
+  for (auto& arg : args) {
+    argv.push_back(arg.data());
+  }
+  argv.push_back(nullptr);
+
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return {};
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const pid_t child = fork();
+  if (child == 0) {
+    close(fds[0]);
+    const pid_t driver = fork();
+    if (driver == 0) {
+      const std::string err = trace.empty() || compiler.is_clang
+                                  ? std::string{"/dev/null"}
+                                  : trace.string();
+      const int err_fd =
+          open(err.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (err_fd >= 0) {
+        dup2(err_fd, STDERR_FILENO);
+      }
+      execvp(argv[0], argv.data());
+      _exit(127);
+    }
+    int status{0};
+    waitpid(driver, &status, 0);
+    rusage usage{};
+    getrusage(RUSAGE_CHILDREN, &usage);
+    const long result[2]{WIFEXITED(status) && WEXITSTATUS(status) == 0,
+                         usage.ru_maxrss};
+    [[maybe_unused]] const auto written = write(fds[1], result, sizeof result);
+    _exit(0);
+  }
+  close(fds[1]);
+  long result[2]{0, 0};
+  const auto got = read(fds[0], result, sizeof result);
+  close(fds[0]);
+  waitpid(child, nullptr, 0);
+  const auto stop = std::chrono::steady_clock::now();
+  if (got != static_cast<long>(sizeof result)) {
+    return {};
+  }
+  return {result[0] != 0, std::chrono::duration<double>(stop - start).count(),
+          result[1]};
+}
+
+bool detect_clang(const std::string& command) {
+  const auto probe = fs::temp_directory_path() /
+                     ("compile_cost_probe." + std::to_string(getpid()));
+  const std::string shell =
+      command + " --version > " + probe.string() + " 2>/dev/null";
+  const bool ran = std::system(shell.c_str()) == 0;
+  std::ifstream in{probe};
+  std::stringstream text;
+  text << in.rdbuf();
+  fs::remove(probe);
+  return ran && text.str().find("clang") != std::string::npos;
+}
+
+// A row of output: key is subject, variant and instance count
+using Key = std::string;
+using Results = std::map<Key, std::pair<double, double>>;
+
+Results read_baseline(const fs::path& path) {
+  Results results;
+  std::ifstream in{path};
+  std::string line;
+  while (std::getline(in, line)) {
+    std::vector<std::string> fields;
+    std::stringstream row{line};
+    for (std::string field; std::getline(row, field, '\t');) {
+      fields.push_back(field);
+    }
+    if (fields.size() != 5 || fields[0] == "subject") {
+      continue;
+    }
+    try {
+      results[fields[0] + '\t' + fields[1] + '\t' + fields[2]] = {
+          std::stod(fields[3]), std::stod(fields[4])};
+    } catch (const std::exception&) {
+      // "failed" rows have nothing to compare against
+    }
+  }
+  return results;
+}
+
+// Time and memory may each grow this much over the baseline. Wall time of a
+// sub-second compile jitters by more than that, so time also has to grow by
+// kTimeSlack seconds to count.
+constexpr double kTolerance{1.10};
+constexpr double kTimeSlack{0.25};
+
+void usage(const char* program) {
+  std::cerr << "usage: " << program
+            << " [--baseline results.tsv] [--trace dir] [--subject name]"
+               " [--root repo] [instances...]\n"
+               "  CXX and CXXFLAGS pick the compiler and its flags"
+               " (default g++ -O2)\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  fs::path baseline_path;
+  fs::path trace_dir;
+  std::string only;
+  // __FILE__ is as the compiler was given it, so this holds when run from
+  // the directory the bench was built in; --root covers everywhere else
+  fs::path repo_root = fs::absolute(fs::path{__FILE__}).parent_path() / "..";
+  std::vector<std::size_t> counts;
+  for (int idx{1}; idx < argc; ++idx) {
+    const std::string_view arg{argv[idx]};
+    if (arg == "--baseline" && idx + 1 < argc) {
+      baseline_path = argv[++idx];
+    } else if (arg == "--trace" && idx + 1 < argc) {
+      trace_dir = argv[++idx];
+    } else if (arg == "--root" && idx + 1 < argc) {
+      repo_root = argv[++idx];
+    } else if (arg == "--subject" && idx + 1 < argc) {
+      only = argv[++idx];
+    } else if (!arg.empty() && arg.find_first_not_of("0123456789") ==
+                                   std::string_view::npos) {
+      counts.push_back(std::stoul(std::string{arg}));
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (counts.empty()) {
+    // The index_sequence table at width 10 needs over 2 GB at 100 already
+    counts = {10, 100};
+  }
+
+  Compiler compiler;
+  const char* env_compiler = std::getenv("CXX");
+  compiler.command = env_compiler ? env_compiler : "g++";
+  const char* env_flags = std::getenv("CXXFLAGS");
+  std::stringstream flags{env_flags ? env_flags : "-O2"};
+  for (std::string flag; flags >> flag;) {
+    compiler.flags.push_back(flag);
+  }
+  compiler.is_clang = detect_clang(compiler.command);
+
+  const auto work_dir =
+      fs::temp_directory_path() /
+      ("compile_cost_bench." + std::to_string(getpid()));
+  fs::create_directories(work_dir);
+  if (!trace_dir.empty()) {
+    fs::create_directories(trace_dir);
+  }
+  const auto baseline =
+      baseline_path.empty() ? Results{} : read_baseline(baseline_path);
+
+  // Otherwise every compile would fail on its #include with the reason
+  // thrown away
+  for (const auto& subject : subjects()) {
+    const bool selected = only.empty() || subject.name == only;
+    if (selected && !fs::is_directory(repo_root / subject.include_dir)) {
+      std::cerr << "no " << subject.include_dir << " under " << repo_root
+                << "; pass the repository with --root\n";
+      return 2;
+    }
+  }
+
+  // Failed compiles and regressions both fail the run
+  std::size_t failures{0};
+  std::cout << "subject\tformulation\tinstances\tseconds\tpeak MB\n";
+  for (const auto& subject : subjects()) {
+    if (!only.empty() && subject.name != only) {
+      continue;
+    }
+    for (const auto& variant : subject.variants) {
+      for (const std::size_t count : counts) {
+        const std::string key = std::string{subject.name} + '\t' +
+                                std::string{variant.name} + '\t' +
+                                std::to_string(count);
+        std::string stem;
+        for (const char chr : key) {
+          const bool plain = std::isalnum(static_cast<unsigned char>(chr));
+          stem += plain ? chr : '_';
+        }
+        auto source = work_dir / (stem + ".cpp");
+        fs::path trace;
+        if (!trace_dir.empty()) {
+          source = trace_dir / (stem + ".cpp");
+          trace = trace_dir / (stem + ".txt");
+        }
+        write_source(source, variant, count);
+        const auto cost = compile(compiler, source,
+                                  repo_root / subject.include_dir, trace);
+
+        // stdout stays a clean table that can be the next run's baseline
+        if (!cost.ok) {
+          std::cout << key << "\tfailed\tfailed" << std::endl;
+          std::cerr << "failed: " << key << '\n';
+          ++failures;
+          continue;
+        }
+        const double peak_mb = static_cast<double>(cost.peak_kb) / 1024.0;
+        std::cout << key << '\t' << cost.seconds << '\t' << peak_mb
+                  << std::endl;
+        if (const auto found = baseline.find(key); found != baseline.end()) {
+          const auto [seconds, mb] = found->second;
+          const bool slower = cost.seconds > seconds * kTolerance &&
+                              cost.seconds > seconds + kTimeSlack;
+          if (slower || peak_mb > mb * kTolerance) {
+            std::cerr << "regression: " << key << " was " << seconds
+                      << " s, " << mb << " MB\n";
+            ++failures;
+          }
+        }
+      }
+    }
+  }
+  fs::remove_all(work_dir);
+  return failures == 0 ? 0 : 1;
+}
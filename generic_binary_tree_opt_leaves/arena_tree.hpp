@@ -0,0 +1,174 @@
+/**
+ * @brief Binary tree whose nodes live in one contiguous pool
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef ARENA_TREE_HPP
+#define ARENA_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Binary tree stored as an array of nodes linked by 32-bit indices
+ *
+ * Nodes are bump allocated from the end of the pool, or reused from a free
+ * list threaded through the left links of freed nodes. A missing child is
+ * kNoNode. Freeing a single node is O(1) and does not touch its children;
+ * Clear() drops every node at once, which is O(1) apart from the value
+ * destructors when TValueType is not trivially destructible.
+ *
+ * Indices stay valid until the node is freed or the tree cleared. Values of
+ * freed nodes are kept until the slot is reused.
+ */
+template <typename TValueType>
+class ArenaBinaryTree {
+public:
+  using NodeIndex = std::uint32_t;
+  static constexpr NodeIndex kNoNode = std::numeric_limits<NodeIndex>::max();
+
+  /**
+   * @brief Lightweight handle mirroring the BinaryTreeNode interface
+   */
+  class NodeRef {
+  public:
+    NodeRef(ArenaBinaryTree& tree, NodeIndex index)
+        : m_tree{&tree}, m_index{index} {}
+
+    [[nodiscard]] NodeIndex Index() const noexcept { return m_index; }
+
+    [[nodiscard]] TValueType& Value() const noexcept {
+      return m_tree->Value(m_index);
+    }
+
+    void SetValue(TValueType&& val) const {
+      m_tree->Value(m_index) = std::forward<TValueType>(val);
+    }
+
+    NodeRef SetLeftChild(TValueType&& val) const {
+      const auto child = m_tree->NewNode(std::forward<TValueType>(val));
+      m_tree->SetLeftChild(m_index, child);
+      return {*m_tree, child};
+    }
+
+    NodeRef SetRightChild(TValueType&& val) const {
+      const auto child = m_tree->NewNode(std::forward<TValueType>(val));
+      m_tree->SetRightChild(m_index, child);
+      return {*m_tree, child};
+    }
+
+    [[nodiscard]] std::optional<NodeRef> GetLeftChild() const {
+      return Wrap(m_tree->LeftChild(m_index));
+    }
+
+    [[nodiscard]] std::optional<NodeRef> GetRightChild() const {
+      return Wrap(m_tree->RightChild(m_index));
+    }
+
+  private:
+    [[nodiscard]] std::optional<NodeRef> Wrap(NodeIndex index) const {
+      if (index == kNoNode) {
+        return std::nullopt;
+      }
+      return NodeRef{*m_tree, index};
+    }
+
+    ArenaBinaryTree* m_tree;
+    NodeIndex m_index;
+  };
+
+  ArenaBinaryTree() = default;
+
+  explicit ArenaBinaryTree(TValueType&& root_value) {
+    m_root = NewNode(std::forward<TValueType>(root_value));
+  }
+
+  // Pre-size the pool when the node count is known up front
+  void Reserve(std::size_t nodes) { m_nodes.reserve(nodes); }
+
+  [[nodiscard]] NodeIndex NewNode(TValueType&& value) {
+    if (m_free_head != kNoNode) {
+      const auto index = m_free_head;
+      auto& node = m_nodes[index];
+      m_free_head = node.left;
+      node = Node{std::forward<TValueType>(value)};
+      ++m_size;
+      return index;
+    }
+    if (m_nodes.size() >= kNoNode) {
+      throw std::length_error("ArenaBinaryTree: more than 2^32 - 1 nodes");
+    }
+    m_nodes.push_back(Node{std::forward<TValueType>(value)});
+    ++m_size;
+    return static_cast<NodeIndex>(m_nodes.size() - 1);
+  }
+
+  /**
+   * @brief Return a node to the free list; its children are left untouched
+   */
+  void FreeNode(NodeIndex index) noexcept {
+    auto& node = m_nodes[index];
+    node.left = m_free_head;
+    node.right = kNoNode;
+    m_free_head = index;
+    if (m_root == index) {
+      m_root = kNoNode;
+    }
+    --m_size;
+  }
+
+  void Clear() noexcept {
+    m_nodes.clear();
+    m_root = kNoNode;
+    m_free_head = kNoNode;
+    m_size = 0;
+  }
+
+  [[nodiscard]] NodeIndex Root() const noexcept { return m_root; }
+  void SetRoot(NodeIndex index) noexcept { m_root = index; }
+  [[nodiscard]] NodeRef RootRef() { return {*this, m_root}; }
+
+  [[nodiscard]] const TValueType& Value(NodeIndex index) const noexcept {
+    return m_nodes[index].value;
+  }
+  [[nodiscard]] TValueType& Value(NodeIndex index) noexcept {
+    return m_nodes[index].value;
+  }
+
+  [[nodiscard]] NodeIndex LeftChild(NodeIndex index) const noexcept {
+    return m_nodes[index].left;
+  }
+  [[nodiscard]] NodeIndex RightChild(NodeIndex index) const noexcept {
+    return m_nodes[index].right;
+  }
+
+  void SetLeftChild(NodeIndex parent, NodeIndex child) noexcept {
+    m_nodes[parent].left = child;
+  }
+  void SetRightChild(NodeIndex parent, NodeIndex child) noexcept {
+    m_nodes[parent].right = child;
+  }
+
+  // Live nodes, not counting freed slots awaiting reuse
+  [[nodiscard]] std::size_t Size() const noexcept { return m_size; }
+
+private:
+  struct Node {
+    TValueType value;
+    NodeIndex left{kNoNode};
+    NodeIndex right{kNoNode};
+  };
+
+  std::vector<Node> m_nodes;
+  NodeIndex m_root{kNoNode};
+  NodeIndex m_free_head{kNoNode};
+  std::size_t m_size{0};
+};
+
+#endif  // ARENA_TREE_HPP
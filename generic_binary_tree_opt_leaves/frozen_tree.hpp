@@ -0,0 +1,176 @@
+/**
+ * @brief Read-only search tree flattened into Eytzinger (BFS) order
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef FROZEN_TREE_HPP
+#define FROZEN_TREE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "tree.hpp"
+
+/**
+ * @brief Immutable binary search tree stored as one array in BFS order
+ *
+ * The node at index k has its children at 2k and 2k + 1 (index 0 is
+ * padding), so a descent reads a handful of predictable addresses instead of
+ * chasing pointers. The shape is always the complete tree over the values,
+ * whatever the shape of the tree it was frozen from.
+ *
+ * Every descent runs a fixed number of levels with the comparison folded
+ * into the index, so there is no data dependent branch, and prefetches the
+ * cache line holding the node's descendants a few levels down. The batched
+ * LowerBound walks a group of queries through the levels in lockstep so
+ * their memory accesses overlap.
+ */
+template <typename TValueType, typename TCompare = std::less<>>
+class FrozenSearchTree {
+public:
+  FrozenSearchTree() = default;
+
+  // sorted must already be ordered by compare
+  explicit FrozenSearchTree(const std::vector<TValueType>& sorted,
+                            TCompare compare = {})
+      : m_compare{std::move(compare)} {
+    if (sorted.empty()) {
+      return;
+    }
+    // The padding slot is only ever read by queries that already finished
+    m_values.assign(sorted.size() + 1, sorted.front());
+    std::size_t next{0};
+    Fill(sorted, 1, next);
+    m_levels = static_cast<std::size_t>(std::bit_width(Size()));
+  }
+
+  [[nodiscard]] std::size_t Size() const noexcept {
+    return m_values.empty() ? 0 : m_values.size() - 1;
+  }
+  [[nodiscard]] bool Empty() const noexcept { return Size() == 0; }
+
+  // First value not ordered before key, null if there is none
+  template <typename TKey>
+  [[nodiscard]] const TValueType* LowerBound(const TKey& key) const {
+    std::size_t index{1};
+    for (std::size_t level{0}; level < m_levels; ++level) {
+      index = Step(index, key);
+    }
+    return Resolve(index);
+  }
+
+  template <typename TKey>
+  [[nodiscard]] bool Contains(const TKey& key) const {
+    const auto* found = LowerBound(key);
+    return found != nullptr && !m_compare(key, *found);
+  }
+
+  /**
+   * @brief LowerBound of every key, written to the matching results slot
+   *
+   * Queries are processed kInterleave at a time, one level of all of them
+   * before the next, so the cache misses of the group are in flight together.
+   */
+  void LowerBound(std::span<const TValueType> keys,
+                  std::span<const TValueType*> results) const {
+    if (results.size() < keys.size()) {
+      throw std::invalid_argument(
+          "FrozenSearchTree: fewer result slots than keys");
+    }
+    std::size_t first{0};
+    for (; first + kInterleave <= keys.size(); first += kInterleave) {
+      std::array<std::size_t, kInterleave> indices;
+      indices.fill(1);
+      for (std::size_t level{0}; level < m_levels; ++level) {
+        for (std::size_t lane{0}; lane < kInterleave; ++lane) {
+          indices[lane] = Step(indices[lane], keys[first + lane]);
+        }
+      }
+      for (std::size_t lane{0}; lane < kInterleave; ++lane) {
+        results[first + lane] = Resolve(indices[lane]);
+      }
+    }
+    for (; first < keys.size(); ++first) {
+      results[first] = LowerBound(keys[first]);
+    }
+  }
+
+  // Queries walked through the levels together by the batched LowerBound
+  static constexpr std::size_t kInterleave{16};
+
+private:
+  // Values per cache line, rounded down to a power of two so the descendants
+  // log2(kLineValues) levels below a node share the prefetched line
+  static constexpr std::size_t kLineValues =
+      std::bit_floor(std::max<std::size_t>(64 / sizeof(TValueType), 1));
+
+  void Fill(const std::vector<TValueType>& sorted, std::size_t index,
+            std::size_t& next) {
+    // In-order over the implicit tree; depth is log2 of the size
+    if (index > Size()) {
+      return;
+    }
+    Fill(sorted, 2 * index, next);
+    m_values[index] = sorted[next++];
+    Fill(sorted, 2 * index + 1, next);
+  }
+
+  /**
+   * @brief One level of descent
+   *
+   * Past the bottom the step still happens, as a right turn off the padding
+   * slot. Right turns are exactly what Resolve strips off, so the answer is
+   * the same as stopping early, and every query takes the same m_levels
+   * steps.
+   */
+  template <typename TKey>
+  [[nodiscard]] std::size_t Step(std::size_t index, const TKey& key) const {
+    const bool inside = index <= Size();
+    // Clamped rather than skipped near the bottom, to stay branch free
+    __builtin_prefetch(
+        m_values.data() + std::min(index * kLineValues, Size()));
+    const auto& probe = m_values[inside ? index : 0];
+    const auto right =
+        static_cast<std::size_t>(!inside || m_compare(probe, key));
+    return 2 * index + right;
+  }
+
+  // Undo the trailing right turns and the final left one to find the answer
+  [[nodiscard]] const TValueType* Resolve(std::size_t index) const noexcept {
+    index >>= std::countr_one(index) + 1;
+    return index == 0 ? nullptr : &m_values[index];
+  }
+
+  std::vector<TValueType> m_values;
+  std::size_t m_levels{0};
+  [[no_unique_address]] TCompare m_compare;
+};
+
+/**
+ * @brief Flatten a binary search tree into a FrozenSearchTree
+ *
+ * The tree is read in order, so it must be ordered by compare; anything else
+ * throws std::invalid_argument.
+ */
+template <typename TValueType, typename TCompare = std::less<>>
+FrozenSearchTree<TValueType, TCompare> Freeze(
+    const BinaryTreeNode<TValueType>& tree, TCompare compare = {}) {
+  std::vector<TValueType> sorted;
+  for (const auto& value : tree.InOrder()) {
+    sorted.push_back(value);
+  }
+  if (!std::is_sorted(sorted.begin(), sorted.end(), compare)) {
+    throw std::invalid_argument("Freeze: tree is not a search tree");
+  }
+  return FrozenSearchTree<TValueType, TCompare>{sorted, std::move(compare)};
+}
+
+#endif  // FROZEN_TREE_HPP
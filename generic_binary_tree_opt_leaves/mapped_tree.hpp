@@ -0,0 +1,303 @@
+/**
+ * @brief Position independent on-disk BinaryTree, read in place through mmap
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef MAPPED_TREE_HPP
+#define MAPPED_TREE_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tree.hpp"
+
+/**
+ * File layout, all in the writer's byte order (which the reader checks):
+ *
+ *   MappedTreeHeader, padded to kMappedTreeHeaderSize bytes
+ *   node_count MappedBinaryTreeNode records, children before parents
+ *
+ * A record refers to its children by byte offset relative to its own start,
+ * 0 meaning no child, so the file means the same wherever it is mapped.
+ */
+inline constexpr std::uint32_t kMappedTreeVersion{1};
+inline constexpr std::size_t kMappedTreeHeaderSize{64};
+inline constexpr char kMappedTreeMagic[8] = {'M', 'G', 'B', 'T',
+                                             'R', 'E', 'E', '\0'};
+// Reads back as 0x04030201 when the file comes from the other byte order
+inline constexpr std::uint32_t kMappedTreeByteOrder{0x01020304};
+
+struct MappedTreeHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t value_size;
+  std::uint32_t value_align;
+  std::uint32_t node_size;
+  std::uint32_t reserved;
+  std::uint64_t node_count;
+  // From the start of the file, 0 for an empty tree
+  std::uint64_t root_offset;
+};
+
+static_assert(sizeof(MappedTreeHeader) <= kMappedTreeHeaderSize);
+
+/**
+ * @brief One node as it sits in the file, navigated without any decoding
+ */
+template <typename TValueType>
+struct MappedBinaryTreeNode {
+  static_assert(std::is_trivially_copyable_v<TValueType>,
+                "only trivially copyable values can be stored by bytes");
+  static_assert(alignof(TValueType) <= kMappedTreeHeaderSize,
+                "records must stay aligned after the header");
+
+  [[nodiscard]] const TValueType& Value() const noexcept { return m_value; }
+
+  // Same names as BinaryTreeNode's, so walkers can take either tree
+  [[nodiscard]] const MappedBinaryTreeNode* GetLeftChildPtr() const noexcept {
+    return At(m_left);
+  }
+  [[nodiscard]] const MappedBinaryTreeNode* GetRightChildPtr()
+      const noexcept {
+    return At(m_right);
+  }
+
+  [[nodiscard]] bool IsLeaf() const noexcept {
+    return m_left == 0 && m_right == 0;
+  }
+
+  TValueType m_value;
+  std::int64_t m_left;
+  std::int64_t m_right;
+
+private:
+  [[nodiscard]] const MappedBinaryTreeNode* At(
+      std::int64_t offset) const noexcept {
+    if (offset == 0) {
+      return nullptr;
+    }
+    const auto* self = reinterpret_cast<const std::byte*>(this);
+    return reinterpret_cast<const MappedBinaryTreeNode*>(self + offset);
+  }
+};
+
+/**
+ * @brief Write tree to path in one post-order pass
+ *
+ * Children are written before their parent, so every offset is known by the
+ * time its record is written; only the header is revisited at the end. A
+ * moved-from tree is written as an empty one. Throws std::runtime_error if
+ * the file can't be written.
+ */
+template <typename TValueType>
+void WriteMappedTree(const BinaryTreeNode<TValueType>& tree,
+                     const std::string& path) {
+  using Record = MappedBinaryTreeNode<TValueType>;
+  std::ofstream out{path, std::ios::binary | std::ios::trunc};
+  if (!out) {
+    throw std::runtime_error("WriteMappedTree: cannot open " + path);
+  }
+
+  const char padding[kMappedTreeHeaderSize]{};
+  out.write(padding, kMappedTreeHeaderSize);
+
+  std::uint64_t written{0};
+  const auto position = [&written] {
+    return kMappedTreeHeaderSize + written * sizeof(Record);
+  };
+  const auto relative = [](std::uint64_t target, std::uint64_t self) {
+    return static_cast<std::int64_t>(target) - static_cast<std::int64_t>(self);
+  };
+
+  // Nodes whose children have been pushed are marked expanded; file offsets
+  // of finished subtrees wait on their own stack until the parent is written
+  std::vector<std::pair<const BinaryTreeNode<TValueType>*, bool>> pending;
+  std::vector<std::uint64_t> finished;
+  if (tree.HasValue()) {
+    pending.emplace_back(&tree, false);
+  }
+  while (!pending.empty()) {
+    auto& [node, expanded] = pending.back();
+    const auto* left = node->GetLeftChildPtr();
+    const auto* right = node->GetRightChildPtr();
+    if (!expanded) {
+      expanded = true;
+      // Right below left so the left subtree is written, and finished, first.
+      // The pushes may reallocate, so node and expanded are not used after
+      if (right != nullptr) {
+        pending.emplace_back(right, false);
+      }
+      if (left != nullptr) {
+        pending.emplace_back(left, false);
+      }
+      continue;
+    }
+
+    const auto self = position();
+    // Zeroed as a whole so the padding after the value reaches the file as
+    // zeros rather than whatever was on the stack
+    Record record;
+    std::memset(static_cast<void*>(&record), 0, sizeof(Record));
+    std::memcpy(&record.m_value, &node->Value(), sizeof(TValueType));
+    if (right != nullptr) {
+      record.m_right = relative(finished.back(), self);
+      finished.pop_back();
+    }
+    if (left != nullptr) {
+      record.m_left = relative(finished.back(), self);
+      finished.pop_back();
+    }
+    out.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+    finished.push_back(self);
+    ++written;
+    pending.pop_back();
+  }
+
+  MappedTreeHeader header{};
+  std::memcpy(header.magic, kMappedTreeMagic, sizeof(header.magic));
+  header.version = kMappedTreeVersion;
+  header.byte_order = kMappedTreeByteOrder;
+  header.value_size = sizeof(TValueType);
+  header.value_align = alignof(TValueType);
+  header.node_size = sizeof(Record);
+  header.node_count = written;
+  header.root_offset = finished.empty() ? 0 : finished.back();
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.flush();
+  if (!out) {
+    throw std::runtime_error("WriteMappedTree: failed writing " + path);
+  }
+}
+
+/**
+ * @brief Read-only view of a file written by WriteMappedTree
+ *
+ * Opening maps the file and checks the header against TValueType; the nodes
+ * themselves are neither read nor copied until they are visited, and pages
+ * are shared with every other process mapping the same file. Only the header
+ * is validated, so the file has to come from a trusted writer.
+ */
+template <typename TValueType>
+class MappedBinaryTree {
+public:
+  using Node = MappedBinaryTreeNode<TValueType>;
+
+  explicit MappedBinaryTree(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::runtime_error("MappedBinaryTree: cannot open " + path);
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 ||
+        static_cast<std::size_t>(info.st_size) < kMappedTreeHeaderSize) {
+      ::close(fd);
+      throw std::runtime_error("MappedBinaryTree: truncated file " + path);
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    void* base = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the file alive on its own
+    ::close(fd);
+    if (base == MAP_FAILED) {
+      throw std::runtime_error("MappedBinaryTree: cannot map " + path);
+    }
+    m_base = static_cast<const std::byte*>(base);
+    try {
+      Validate(path);
+    } catch (...) {
+      Unmap();
+      throw;
+    }
+  }
+
+  MappedBinaryTree(const MappedBinaryTree&) = delete;
+  MappedBinaryTree& operator=(const MappedBinaryTree&) = delete;
+  MappedBinaryTree(MappedBinaryTree&& other) noexcept
+      : m_base{std::exchange(other.m_base, nullptr)},
+        m_size{std::exchange(other.m_size, 0)} {}
+  MappedBinaryTree& operator=(MappedBinaryTree&& other) noexcept {
+    if (&other != this) {
+      Unmap();
+      m_base = std::exchange(other.m_base, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+  }
+  ~MappedBinaryTree() { Unmap(); }
+
+  [[nodiscard]] std::size_t Size() const noexcept {
+    return static_cast<std::size_t>(Header().node_count);
+  }
+
+  // Null for an empty tree
+  [[nodiscard]] const Node* Root() const noexcept {
+    const auto offset = Header().root_offset;
+    return offset == 0 ? nullptr
+                       : reinterpret_cast<const Node*>(m_base + offset);
+  }
+
+private:
+  [[nodiscard]] const MappedTreeHeader& Header() const noexcept {
+    return *reinterpret_cast<const MappedTreeHeader*>(m_base);
+  }
+
+  void Validate(const std::string& path) const {
+    const auto& header = Header();
+    const auto fail = [&path](const char* what) {
+      throw std::runtime_error(std::string{"MappedBinaryTree: "} + what +
+                               " in " + path);
+    };
+    if (std::memcmp(header.magic, kMappedTreeMagic, sizeof(header.magic)) !=
+        0) {
+      fail("not a tree file");
+    }
+    if (header.byte_order != kMappedTreeByteOrder) {
+      fail("foreign byte order");
+    }
+    if (header.version != kMappedTreeVersion) {
+      fail("unsupported version");
+    }
+    if (header.value_size != sizeof(TValueType) ||
+        header.value_align != alignof(TValueType) ||
+        header.node_size != sizeof(Node)) {
+      fail("value type mismatch");
+    }
+    if (header.node_count > m_size / sizeof(Node) ||
+        kMappedTreeHeaderSize + header.node_count * sizeof(Node) > m_size) {
+      fail("truncated nodes");
+    }
+    const auto nodes_end =
+        kMappedTreeHeaderSize + header.node_count * sizeof(Node);
+    const bool root_inside = header.root_offset >= kMappedTreeHeaderSize &&
+                             header.root_offset + sizeof(Node) <= nodes_end;
+    if (header.node_count == 0 ? header.root_offset != 0 : !root_inside) {
+      fail("bad root offset");
+    }
+  }
+
+  void Unmap() noexcept {
+    if (m_base != nullptr) {
+      ::munmap(const_cast<std::byte*>(m_base), m_size);
+      m_base = nullptr;
+    }
+  }
+
+  const std::byte* m_base{nullptr};
+  std::size_t m_size{0};
+};
+
+#endif  // MAPPED_TREE_HPP
@@ -0,0 +1,204 @@
+/**
+ * @brief Binary tree with immutable, shared nodes and O(1) snapshots
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef PERSISTENT_TREE_HPP
+#define PERSISTENT_TREE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template <typename TValueType>
+struct PersistentBinaryTreeNode;
+
+/**
+ * @brief Handle to one version of a tree whose nodes are never modified
+ *
+ * Nodes are reference counted and shared between every version that can
+ * reach them, so copying a tree is a single reference count increment. An
+ * edit copies only the nodes on the path from the root down to the node being
+ * changed and points the copies at the untouched subtrees of the original;
+ * every other handle keeps seeing the version it was copied from.
+ *
+ * Edits address a node by the sequence of sides taken from the root, an empty
+ * path being the root itself, and throw std::out_of_range if the path runs
+ * off the tree. A default constructed tree is empty.
+ */
+template <typename TValueType>
+class PersistentBinaryTree {
+public:
+  enum class Side : bool { kLeft, kRight };
+  using Path = std::span<const Side>;
+
+  PersistentBinaryTree() = default;
+
+  explicit PersistentBinaryTree(TValueType&& value)
+      : m_root{std::make_shared<Node>(
+            Node{std::forward<TValueType>(value), {}, {}})} {}
+
+  PersistentBinaryTree(TValueType&& value, PersistentBinaryTree left,
+                       PersistentBinaryTree right)
+      : m_root{std::make_shared<Node>(Node{std::forward<TValueType>(value),
+                                           std::move(left),
+                                           std::move(right)})} {}
+
+  PersistentBinaryTree(const PersistentBinaryTree&) = default;
+  PersistentBinaryTree(PersistentBinaryTree&&) noexcept = default;
+
+  // The previous nodes are released by the destructor of a temporary, so
+  // assignment is no more recursive than destruction
+  PersistentBinaryTree& operator=(const PersistentBinaryTree& other) {
+    PersistentBinaryTree previous{std::move(*this)};
+    m_root = other.m_root;
+    return *this;
+  }
+  PersistentBinaryTree& operator=(PersistentBinaryTree&& other) noexcept {
+    PersistentBinaryTree previous{std::move(*this)};
+    m_root = std::move(other.m_root);
+    return *this;
+  }
+
+  /**
+   * Releasing a node releases its children from inside its own destructor,
+   * which for a deep tree would nest as deep as the tree. Nodes this handle
+   * alone keeps alive are detached onto an explicit stack first, so each one
+   * is freed with no uniquely owned children left; nodes that other versions
+   * still reach are only unreferenced.
+   */
+  ~PersistentBinaryTree() {
+    if (m_root == nullptr || m_root.use_count() != 1) {
+      return;
+    }
+    std::vector<std::shared_ptr<Node>> pending;
+    pending.push_back(std::move(m_root));
+    while (!pending.empty()) {
+      const std::shared_ptr<Node> node{std::move(pending.back())};
+      pending.pop_back();
+      for (auto* child : {&node->m_left.m_root, &node->m_right.m_root}) {
+        if (*child != nullptr && child->use_count() == 1) {
+          pending.push_back(std::move(*child));
+        }
+      }
+    }
+  }
+
+  [[nodiscard]] bool Empty() const noexcept { return m_root == nullptr; }
+  explicit operator bool() const noexcept { return !Empty(); }
+
+  [[nodiscard]] const TValueType& Value() const noexcept {
+    return m_root->m_value;
+  }
+
+  // Empty when there is no child on that side
+  [[nodiscard]] const PersistentBinaryTree& GetLeftChild() const noexcept {
+    return m_root->m_left;
+  }
+  [[nodiscard]] const PersistentBinaryTree& GetRightChild() const noexcept {
+    return m_root->m_right;
+  }
+
+  // Subtree at the end of path, empty if the path runs off the tree
+  [[nodiscard]] const PersistentBinaryTree& Find(Path path) const noexcept {
+    const auto* tree = this;
+    for (const auto side : path) {
+      if (tree->Empty()) {
+        break;
+      }
+      tree = &tree->Child(side);
+    }
+    return *tree;
+  }
+
+  void SetValue(TValueType&& val) { SetValue({}, std::move(val)); }
+  void SetValue(Path path, TValueType&& val) {
+    Rebuild(path, [&val](const Node& node) {
+      return Node{std::forward<TValueType>(val), node.m_left, node.m_right};
+    });
+  }
+
+  void SetLeftChild(const PersistentBinaryTree& child) {
+    SetLeftChild({}, child);
+  }
+  void SetLeftChild(Path path, const PersistentBinaryTree& child) {
+    Rebuild(path, [&child](const Node& node) {
+      return Node{node.m_value, child, node.m_right};
+    });
+  }
+
+  void SetRightChild(const PersistentBinaryTree& child) {
+    SetRightChild({}, child);
+  }
+  void SetRightChild(Path path, const PersistentBinaryTree& child) {
+    Rebuild(path, [&child](const Node& node) {
+      return Node{node.m_value, node.m_left, child};
+    });
+  }
+
+  // True when both handles refer to the very same nodes
+  [[nodiscard]] bool SharesRootWith(
+      const PersistentBinaryTree& other) const noexcept {
+    return m_root == other.m_root;
+  }
+
+private:
+  using Node = PersistentBinaryTreeNode<TValueType>;
+
+  explicit PersistentBinaryTree(std::shared_ptr<Node> root) noexcept
+      : m_root{std::move(root)} {}
+
+  [[nodiscard]] const PersistentBinaryTree& Child(Side side) const noexcept {
+    return side == Side::kLeft ? m_root->m_left : m_root->m_right;
+  }
+
+  /**
+   * @brief Replace the node at path with edit(node) and copy its ancestors
+   *
+   * Iterative so the depth of the edit is not limited by the call stack.
+   */
+  template <typename TEdit>
+  void Rebuild(Path path, TEdit&& edit) {
+    std::vector<const Node*> ancestors;
+    ancestors.reserve(path.size());
+    const auto* tree = this;
+    for (const auto side : path) {
+      if (tree->Empty()) {
+        throw std::out_of_range("PersistentBinaryTree: path leaves the tree");
+      }
+      ancestors.push_back(tree->m_root.get());
+      tree = &tree->Child(side);
+    }
+    if (tree->Empty()) {
+      throw std::out_of_range("PersistentBinaryTree: path leaves the tree");
+    }
+
+    PersistentBinaryTree rebuilt{std::make_shared<Node>(edit(*tree->m_root))};
+    for (std::size_t idx{ancestors.size()}; idx-- > 0;) {
+      const auto& parent = *ancestors[idx];
+      rebuilt = PersistentBinaryTree{std::make_shared<Node>(
+          path[idx] == Side::kLeft
+              ? Node{parent.m_value, std::move(rebuilt), parent.m_right}
+              : Node{parent.m_value, parent.m_left, std::move(rebuilt)})};
+    }
+    // The old path is released by rebuilt's destructor
+    m_root.swap(rebuilt.m_root);
+  }
+
+  // Nodes are never modified once built; they are only non-const so that
+  // the destructor can detach the children of a node it is about to free
+  std::shared_ptr<Node> m_root;
+};
+
+template <typename TValueType>
+struct PersistentBinaryTreeNode {
+  TValueType m_value;
+  PersistentBinaryTree<TValueType> m_left;
+  PersistentBinaryTree<TValueType> m_right;
+};
+
+#endif  // PERSISTENT_TREE_HPP
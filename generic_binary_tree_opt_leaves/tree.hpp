@@ -0,0 +1,456 @@
+/**
+ * @brief Generic binary tree of heap allocated nodes
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef TREE_HPP
+#define TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename TValueType>
+struct BinaryTreeLeafImpl;
+
+template <typename TValueType>
+struct BinaryTreeNodeImpl;
+
+enum class TraversalOrder { kPreOrder, kInOrder, kPostOrder, kLevelOrder };
+
+/**
+ * @brief Owning handle to a node and, through it, the subtree below
+ *
+ * Leaves are allocated as bare values with no child slots and are promoted to
+ * full interior nodes the first time a child slot is needed. Which of the two
+ * a node is lives in the low bit of the handle's pointer, so the handle stays
+ * one pointer wide. Read through the const GetLeftChild/GetRightChild to
+ * avoid promoting leaves; the non-const overloads hand out an assignable slot
+ * and therefore promote.
+ *
+ * Copying and destroying walk the tree iteratively, so neither is limited by
+ * the depth of the tree.
+ */
+template <typename TValueType>
+struct BinaryTreeNode {
+private:
+  // Only the node itself can name this, which keeps the adopting constructor
+  // out of the public interface while still letting std::optional call it
+  struct AdoptTag {};
+
+public:
+  template <TraversalOrder TOrder>
+  class Iterator;
+
+  template <TraversalOrder TOrder>
+  class Traversal;
+
+  constexpr BinaryTreeNode();
+  constexpr BinaryTreeNode(TValueType&& value);
+
+  // Takes ownership of an already tagged node pointer
+  BinaryTreeNode(AdoptTag, std::uintptr_t bits) noexcept : m_bits{bits} {}
+
+  BinaryTreeNode(const BinaryTreeNode<TValueType>& other);
+  BinaryTreeNode& operator=(const BinaryTreeNode<TValueType>& other);
+  BinaryTreeNode(BinaryTreeNode<TValueType>&& other) noexcept
+      : m_bits{std::exchange(other.m_bits, 0)} {}
+  BinaryTreeNode& operator=(BinaryTreeNode<TValueType>&& other) noexcept {
+    if (&other != this) {
+      Destroy();
+      m_bits = std::exchange(other.m_bits, 0);
+    }
+    return *this;
+  }
+  ~BinaryTreeNode() { Destroy(); }
+
+  [[nodiscard]] const TValueType& Value() const noexcept {
+    return Leaf()->m_value;
+  }
+  [[nodiscard]] TValueType& Value() noexcept { return Leaf()->m_value; }
+
+  void SetValue(TValueType&& val) {
+    Leaf()->m_value = std::forward<TValueType>(val);
+  }
+
+  BinaryTreeNode<TValueType>& operator=(TValueType&& val) {
+    Leaf()->m_value = std::forward<TValueType>(val);
+    return *this;
+  }
+
+  std::optional<BinaryTreeNode<TValueType>>& SetLeftChild(
+      const BinaryTreeNode<TValueType>& node) {
+    auto& slot = Promote()->m_left;
+    slot = node;
+    return slot;
+  }
+
+  std::optional<BinaryTreeNode<TValueType>>& SetRightChild(
+      const BinaryTreeNode<TValueType>& node) {
+    auto& slot = Promote()->m_right;
+    slot = node;
+    return slot;
+  }
+
+  std::optional<BinaryTreeNode<TValueType>>& GetLeftChild() {
+    return Promote()->m_left;
+  }
+  const std::optional<BinaryTreeNode<TValueType>>& GetLeftChild() const {
+    return IsLeaf() ? NoChild() : Interior()->m_left;
+  }
+
+  std::optional<BinaryTreeNode<TValueType>>& GetRightChild() {
+    return Promote()->m_right;
+  }
+  const std::optional<BinaryTreeNode<TValueType>>& GetRightChild() const {
+    return IsLeaf() ? NoChild() : Interior()->m_right;
+  }
+
+  // Non-promoting child access for walkers, null when there is no child
+  [[nodiscard]] const BinaryTreeNode* GetLeftChildPtr() const noexcept {
+    return IsLeaf() ? nullptr : Present(Interior()->m_left);
+  }
+  [[nodiscard]] const BinaryTreeNode* GetRightChildPtr() const noexcept {
+    return IsLeaf() ? nullptr : Present(Interior()->m_right);
+  }
+
+  // False only for a node that has been moved from
+  [[nodiscard]] bool HasValue() const noexcept { return m_bits != 0; }
+
+  // True until a child slot has been requested
+  [[nodiscard]] bool IsLeaf() const noexcept {
+    return (m_bits & kInteriorTag) == 0;
+  }
+
+  /**
+   * @brief Ranges over the values of the subtree rooted here
+   *
+   * The iterators keep their own stack (or queue, for level order) of
+   * pending nodes, so they work at any depth and never promote leaves.
+   * Structural changes to the tree invalidate them.
+   */
+  [[nodiscard]] Traversal<TraversalOrder::kPreOrder> PreOrder() const noexcept {
+    return Traversal<TraversalOrder::kPreOrder>{this};
+  }
+  [[nodiscard]] Traversal<TraversalOrder::kInOrder> InOrder() const noexcept {
+    return Traversal<TraversalOrder::kInOrder>{this};
+  }
+  [[nodiscard]] Traversal<TraversalOrder::kPostOrder> PostOrder()
+      const noexcept {
+    return Traversal<TraversalOrder::kPostOrder>{this};
+  }
+  [[nodiscard]] Traversal<TraversalOrder::kLevelOrder> LevelOrder()
+      const noexcept {
+    return Traversal<TraversalOrder::kLevelOrder>{this};
+  }
+
+private:
+  using LeafImpl = BinaryTreeLeafImpl<TValueType>;
+  using InteriorImpl = BinaryTreeNodeImpl<TValueType>;
+
+  // Node allocations are at least new-aligned, so bit 0 is free for the tag
+  static constexpr std::uintptr_t kInteriorTag{1};
+  // What the const child accessors return for a leaf. A function local static
+  // because an optional<BinaryTreeNode> member can't be declared before the
+  // class is complete
+  static const std::optional<BinaryTreeNode<TValueType>>& NoChild() noexcept {
+    static const std::optional<BinaryTreeNode<TValueType>> none{};
+    return none;
+  }
+
+  static std::uintptr_t Tag(LeafImpl* leaf) noexcept {
+    return reinterpret_cast<std::uintptr_t>(leaf);
+  }
+  static std::uintptr_t Tag(InteriorImpl* interior) noexcept {
+    // Go through the base so the stored address is always the LeafImpl part
+    auto* base = static_cast<LeafImpl*>(interior);
+    return reinterpret_cast<std::uintptr_t>(base) | kInteriorTag;
+  }
+
+  static LeafImpl* LeafOf(std::uintptr_t bits) noexcept {
+    return reinterpret_cast<LeafImpl*>(bits & ~kInteriorTag);
+  }
+  static InteriorImpl* InteriorOf(std::uintptr_t bits) noexcept {
+    return static_cast<InteriorImpl*>(LeafOf(bits));
+  }
+
+  [[nodiscard]] LeafImpl* Leaf() const noexcept { return LeafOf(m_bits); }
+  [[nodiscard]] InteriorImpl* Interior() const noexcept {
+    return InteriorOf(m_bits);
+  }
+
+  // A slot can be engaged but hold a moved-from node
+  static const BinaryTreeNode* Present(
+      const std::optional<BinaryTreeNode<TValueType>>& slot) noexcept {
+    return slot && slot->m_bits != 0 ? &*slot : nullptr;
+  }
+
+  static std::uintptr_t Take(
+      std::optional<BinaryTreeNode<TValueType>>& slot) noexcept {
+    return slot ? std::exchange(slot->m_bits, 0) : 0;
+  }
+
+  static void Put(std::optional<BinaryTreeNode<TValueType>>& slot,
+                  std::uintptr_t bits) noexcept {
+    if (slot) {
+      slot->m_bits = bits;
+    } else {
+      slot.emplace(AdoptTag{}, bits);
+    }
+  }
+
+  // A copy of the node's value, as a leaf or a childless interior node
+  static std::uintptr_t CopyNode(const BinaryTreeNode& node) {
+    if (node.m_bits == 0) {
+      return 0;
+    }
+    if (node.IsLeaf()) {
+      return Tag(new LeafImpl{node.Value()});
+    }
+    return Tag(new InteriorImpl{{node.Value()}, {}, {}});
+  }
+
+  InteriorImpl* Promote() {
+    if (IsLeaf()) {
+      auto* leaf = Leaf();
+      auto* interior = new InteriorImpl{{std::move(leaf->m_value)}, {}, {}};
+      delete leaf;
+      m_bits = Tag(interior);
+    }
+    return Interior();
+  }
+
+  /**
+   * @brief Free the subtree in constant space
+   *
+   * Rotates the left child above its parent until the current node has no
+   * left subtree, then frees it and moves on to its right one. Leaves hanging
+   * on the left are freed directly since they have no slot to rotate through.
+   */
+  void Destroy() noexcept {
+    auto bits = std::exchange(m_bits, 0);
+    while (bits != 0) {
+      if ((bits & kInteriorTag) == 0) {
+        // Nothing else is reachable from a leaf
+        delete LeafOf(bits);
+        break;
+      }
+      auto* node = InteriorOf(bits);
+      const auto left = Take(node->m_left);
+      if (left == 0) {
+        bits = Take(node->m_right);
+        delete node;
+      } else if ((left & kInteriorTag) == 0) {
+        delete LeafOf(left);
+      } else {
+        auto* pivot = InteriorOf(left);
+        Put(node->m_left, Take(pivot->m_right));
+        Put(pivot->m_right, bits);
+        bits = left;
+      }
+    }
+  }
+
+  std::uintptr_t m_bits{0};
+};
+
+template <typename TValueType>
+struct BinaryTreeLeafImpl {
+  TValueType m_value;
+};
+
+template <typename TValueType>
+struct BinaryTreeNodeImpl : BinaryTreeLeafImpl<TValueType> {
+  std::optional<BinaryTreeNode<TValueType>> m_left;
+  std::optional<BinaryTreeNode<TValueType>> m_right;
+};
+
+/**
+ * @brief Forward iterator over the values of a subtree in the given order
+ *
+ * A default constructed iterator is the end iterator.
+ */
+template <typename TValueType>
+template <TraversalOrder TOrder>
+class BinaryTreeNode<TValueType>::Iterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = TValueType;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const TValueType*;
+  using reference = const TValueType&;
+
+  Iterator() = default;
+
+  explicit Iterator(const BinaryTreeNode* root) {
+    if (root == nullptr || root->m_bits == 0) {
+      return;
+    }
+    if constexpr (TOrder == TraversalOrder::kPreOrder ||
+                  TOrder == TraversalOrder::kLevelOrder) {
+      m_pending.push_back(root);
+    } else if constexpr (TOrder == TraversalOrder::kInOrder) {
+      PushLeftSpine(root);
+    } else {
+      PushFirstPostOrder(root);
+    }
+  }
+
+  reference operator*() const noexcept { return Current()->Value(); }
+  pointer operator->() const noexcept { return &Current()->Value(); }
+
+  Iterator& operator++() {
+    if constexpr (TOrder == TraversalOrder::kPreOrder) {
+      const auto* node = m_pending.back();
+      m_pending.pop_back();
+      // Right first so the left subtree comes off the stack first
+      Push(node->GetRightChildPtr());
+      Push(node->GetLeftChildPtr());
+    } else if constexpr (TOrder == TraversalOrder::kInOrder) {
+      const auto* node = m_pending.back();
+      m_pending.pop_back();
+      PushLeftSpine(node->GetRightChildPtr());
+    } else if constexpr (TOrder == TraversalOrder::kPostOrder) {
+      const auto* node = m_pending.back();
+      m_pending.pop_back();
+      if (!m_pending.empty()) {
+        // Coming up from the left, the parent's right subtree is next
+        const auto* parent = m_pending.back();
+        const auto* right = parent->GetRightChildPtr();
+        if (node == parent->GetLeftChildPtr() && right != nullptr) {
+          PushFirstPostOrder(right);
+        }
+      }
+    } else {
+      const auto* node = m_pending.front();
+      m_pending.pop_front();
+      Push(node->GetLeftChildPtr());
+      Push(node->GetRightChildPtr());
+    }
+    return *this;
+  }
+
+  Iterator operator++(int) {
+    auto copy = *this;
+    ++*this;
+    return copy;
+  }
+
+  friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+    if (lhs.m_pending.empty() || rhs.m_pending.empty()) {
+      return lhs.m_pending.empty() == rhs.m_pending.empty();
+    }
+    return lhs.Current() == rhs.Current();
+  }
+
+private:
+  // Stack for the depth first orders, queue for level order
+  using Pending = std::conditional_t<TOrder == TraversalOrder::kLevelOrder,
+                                     std::deque<const BinaryTreeNode*>,
+                                     std::vector<const BinaryTreeNode*>>;
+
+  [[nodiscard]] const BinaryTreeNode* Current() const noexcept {
+    if constexpr (TOrder == TraversalOrder::kLevelOrder) {
+      return m_pending.front();
+    } else {
+      return m_pending.back();
+    }
+  }
+
+  void Push(const BinaryTreeNode* node) {
+    if (node != nullptr) {
+      m_pending.push_back(node);
+    }
+  }
+
+  void PushLeftSpine(const BinaryTreeNode* node) {
+    for (; node != nullptr; node = node->GetLeftChildPtr()) {
+      m_pending.push_back(node);
+    }
+  }
+
+  // Descend to the first node of the subtree in post-order, preferring left
+  void PushFirstPostOrder(const BinaryTreeNode* node) {
+    while (node != nullptr) {
+      m_pending.push_back(node);
+      const auto* left = node->GetLeftChildPtr();
+      node = left != nullptr ? left : node->GetRightChildPtr();
+    }
+  }
+
+  Pending m_pending;
+};
+
+template <typename TValueType>
+template <TraversalOrder TOrder>
+class BinaryTreeNode<TValueType>::Traversal {
+public:
+  explicit Traversal(const BinaryTreeNode* root) noexcept : m_root{root} {}
+
+  [[nodiscard]] Iterator<TOrder> begin() const {
+    return Iterator<TOrder>{m_root};
+  }
+  [[nodiscard]] Iterator<TOrder> end() const noexcept { return {}; }
+
+private:
+  const BinaryTreeNode* m_root;
+};
+
+template <typename TValueType>
+constexpr BinaryTreeNode<TValueType>::BinaryTreeNode()
+    : m_bits{Tag(new BinaryTreeLeafImpl<TValueType>())} {}
+
+template <typename TValueType>
+constexpr BinaryTreeNode<TValueType>::BinaryTreeNode(TValueType&& value)
+    : m_bits{Tag(new BinaryTreeLeafImpl<TValueType>{
+          std::forward<TValueType>(value)})} {}
+
+template <typename TValueType>
+BinaryTreeNode<TValueType>::BinaryTreeNode(
+    const BinaryTreeNode<TValueType>& other) {
+  // Built in a local so a throwing value copy frees what was copied so far
+  BinaryTreeNode copy{AdoptTag{}, CopyNode(other)};
+  // Source nodes paired with their copies, whose children are still missing
+  std::vector<std::pair<const BinaryTreeNode*, BinaryTreeNode*>> pending;
+  if (!copy.IsLeaf()) {
+    pending.emplace_back(&other, &copy);
+  }
+  while (!pending.empty()) {
+    const auto [from, to] = pending.back();
+    pending.pop_back();
+    const auto* source = from->Interior();
+    auto* target = to->Interior();
+    for (const auto& [from_slot, to_slot] :
+         {std::pair{&source->m_left, &target->m_left},
+          std::pair{&source->m_right, &target->m_right}}) {
+      if (!*from_slot) {
+        continue;
+      }
+      Put(*to_slot, CopyNode(**from_slot));
+      if (!(*to_slot)->IsLeaf()) {
+        pending.emplace_back(&**from_slot, &**to_slot);
+      }
+    }
+  }
+  m_bits = std::exchange(copy.m_bits, 0);
+}
+
+template <typename TValueType>
+BinaryTreeNode<TValueType>& BinaryTreeNode<TValueType>::operator=(
+    const BinaryTreeNode<TValueType>& other) {
+  if (&other != this) {
+    *this = BinaryTreeNode<TValueType>{other};
+  }
+  return *this;
+}
+
+template <typename TValueType>
+using BinaryTree = BinaryTreeNode<TValueType>;
+
+#endif  // TREE_HPP
@@ -0,0 +1,490 @@
+#include <malloc.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arena_tree.hpp"
+#include "frozen_tree.hpp"
+#include "mapped_tree.hpp"
+#include "persistent_tree.hpp"
+#include "tree.hpp"
+#include "tree_parallel.hpp"
+
+namespace {
+
+// Keeps the optimizer from discarding the work being measured
+volatile std::uint64_t g_sink{0};
+
+template <typename TFunc>
+double time_ns(TFunc&& func) {
+  const auto start = std::chrono::steady_clock::now();
+  func();
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+// Bytes currently handed out by malloc, including mmapped blocks
+std::size_t heap_in_use() {
+  const auto info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+// Splits the remaining nodes evenly so the tree is balanced
+void build_pointer_tree(BinaryTreeNode<int>& node, std::size_t nodes,
+                        int& next) {
+  const std::size_t remaining = nodes - 1;
+  const std::size_t left = remaining / 2;
+  const std::size_t right = remaining - left;
+  if (left > 0) {
+    auto& child = node.SetLeftChild(BinaryTreeNode<int>{next++});
+    build_pointer_tree(*child, left, next);
+  }
+  if (right > 0) {
+    auto& child = node.SetRightChild(BinaryTreeNode<int>{next++});
+    build_pointer_tree(*child, right, next);
+  }
+}
+
+void build_arena_tree(ArenaBinaryTree<int>& tree,
+                      ArenaBinaryTree<int>::NodeIndex node, std::size_t nodes,
+                      int& next) {
+  const std::size_t remaining = nodes - 1;
+  const std::size_t left = remaining / 2;
+  const std::size_t right = remaining - left;
+  if (left > 0) {
+    const auto child = tree.NewNode(next++);
+    tree.SetLeftChild(node, child);
+    build_arena_tree(tree, child, left, next);
+  }
+  if (right > 0) {
+    const auto child = tree.NewNode(next++);
+    tree.SetRightChild(node, child);
+    build_arena_tree(tree, child, right, next);
+  }
+}
+
+std::uint64_t sum_pointer_tree(const BinaryTreeNode<int>& root) {
+  std::uint64_t sum{0};
+  std::vector<const BinaryTreeNode<int>*> stack{&root};
+  while (!stack.empty()) {
+    const auto* node = stack.back();
+    stack.pop_back();
+    sum += static_cast<std::uint64_t>(node->Value());
+    if (const auto& right = node->GetRightChild()) {
+      stack.push_back(&*right);
+    }
+    if (const auto& left = node->GetLeftChild()) {
+      stack.push_back(&*left);
+    }
+  }
+  return sum;
+}
+
+std::uint64_t sum_arena_tree(const ArenaBinaryTree<int>& tree) {
+  using Tree = ArenaBinaryTree<int>;
+  std::uint64_t sum{0};
+  std::vector<Tree::NodeIndex> stack{tree.Root()};
+  while (!stack.empty()) {
+    const auto node = stack.back();
+    stack.pop_back();
+    sum += static_cast<std::uint64_t>(tree.Value(node));
+    if (const auto right = tree.RightChild(node); right != Tree::kNoNode) {
+      stack.push_back(right);
+    }
+    if (const auto left = tree.LeftChild(node); left != Tree::kNoNode) {
+      stack.push_back(left);
+    }
+  }
+  return sum;
+}
+
+void print_row(const char* label, std::size_t nodes, std::size_t bytes,
+               double build_ns, double walk_ns, double free_ns) {
+  const auto per_node = [nodes](double value) {
+    return value / static_cast<double>(nodes);
+  };
+  std::cout << label << '\t' << per_node(static_cast<double>(bytes)) << '\t'
+            << per_node(build_ns) << '\t' << per_node(walk_ns) << '\t'
+            << per_node(free_ns) << '\n';
+}
+
+void bench_layouts(std::size_t nodes) {
+  std::cout << "balanced tree of " << nodes << " int nodes (per node)\n";
+  std::cout << "layout\tbytes\tbuild ns\tpre-order walk ns\tfree ns\n";
+
+  {
+    const auto heap_before = heap_in_use();
+    std::optional<BinaryTreeNode<int>> root;
+    int next{0};
+    const auto build_ns = time_ns([&] {
+      root.emplace(next++);
+      build_pointer_tree(*root, nodes, next);
+    });
+    const auto bytes = heap_in_use() - heap_before;
+    const auto walk_ns =
+        time_ns([&] { g_sink = g_sink + sum_pointer_tree(*root); });
+    const auto free_ns = time_ns([&] { root.reset(); });
+    print_row("pointer", nodes, bytes, build_ns, walk_ns, free_ns);
+  }
+
+  {
+    const auto heap_before = heap_in_use();
+    ArenaBinaryTree<int> tree;
+    int next{0};
+    const auto build_ns = time_ns([&] {
+      tree.Reserve(nodes);
+      tree.SetRoot(tree.NewNode(next++));
+      build_arena_tree(tree, tree.Root(), nodes, next);
+    });
+    const auto bytes = heap_in_use() - heap_before;
+    const auto walk_ns =
+        time_ns([&] { g_sink = g_sink + sum_arena_tree(tree); });
+    const auto free_ns = time_ns([&] { tree.Clear(); });
+    print_row("arena", nodes, bytes, build_ns, walk_ns, free_ns);
+  }
+}
+
+// Pool reuse after freeing: half the nodes are freed and reallocated
+void bench_free_list(std::size_t nodes) {
+  using Tree = ArenaBinaryTree<int>;
+  std::cout << "free and reuse " << nodes / 2 << " arena nodes (ns per node)\n";
+  Tree tree;
+  tree.Reserve(nodes);
+  std::vector<Tree::NodeIndex> indices;
+  indices.reserve(nodes);
+  for (std::size_t idx{0}; idx < nodes; ++idx) {
+    indices.push_back(tree.NewNode(static_cast<int>(idx)));
+  }
+  const auto churn_ns = time_ns([&] {
+    for (std::size_t idx{0}; idx < nodes; idx += 2) {
+      tree.FreeNode(indices[idx]);
+    }
+    for (std::size_t idx{0}; idx < nodes; idx += 2) {
+      indices[idx] = tree.NewNode(static_cast<int>(idx));
+    }
+  });
+  std::cout << churn_ns / static_cast<double>(nodes) << " (live "
+            << tree.Size() << ")\n";
+}
+
+// Same shape and pre-order numbering as build_pointer_tree
+PersistentBinaryTree<int> build_persistent_tree(std::size_t nodes, int& next) {
+  int value = next++;
+  const std::size_t remaining = nodes - 1;
+  const std::size_t left = remaining / 2;
+  const std::size_t right = remaining - left;
+  PersistentBinaryTree<int> left_tree;
+  PersistentBinaryTree<int> right_tree;
+  if (left > 0) {
+    left_tree = build_persistent_tree(left, next);
+  }
+  if (right > 0) {
+    right_tree = build_persistent_tree(right, next);
+  }
+  return {std::move(value), std::move(left_tree), std::move(right_tree)};
+}
+
+// Snapshot, then change one value at the bottom of a random root to leaf path
+void bench_versions(std::size_t nodes, std::size_t versions) {
+  using Tree = PersistentBinaryTree<int>;
+  // Every path this long exists in the balanced tree
+  const std::size_t depth = std::max<std::size_t>(std::bit_width(nodes), 2) - 2;
+  std::mt19937_64 rng{42};
+  const auto random_path = [&rng, depth] {
+    std::vector<Tree::Side> path(depth);
+    for (auto& side : path) {
+      side = static_cast<Tree::Side>(rng() & 1);
+    }
+    return path;
+  };
+
+  std::cout << versions << " versions of a " << nodes
+            << " node tree, one edit at depth " << depth << " each\n";
+  std::cout << "layout\tbytes per version\tns per version\n";
+
+  {
+    int next{0};
+    std::vector<Tree> history{build_persistent_tree(nodes, next)};
+    history.reserve(versions + 1);
+    std::vector<std::vector<Tree::Side>> paths;
+    for (std::size_t idx{0}; idx < versions; ++idx) {
+      paths.push_back(random_path());
+    }
+    const auto heap_before = heap_in_use();
+    const auto edit_ns = time_ns([&] {
+      for (std::size_t idx{0}; idx < versions; ++idx) {
+        auto& version = history.emplace_back(history.back());
+        version.SetValue(paths[idx], static_cast<int>(idx));
+      }
+    });
+    const auto bytes = heap_in_use() - heap_before;
+    std::cout << "persistent\t"
+              << static_cast<double>(bytes) / static_cast<double>(versions)
+              << '\t' << edit_ns / static_cast<double>(versions) << '\n';
+  }
+
+  {
+    // A full copy per version; a handful is enough to see the per version cost
+    const std::size_t copies = std::min<std::size_t>(versions, 3);
+    int next{0};
+    std::vector<BinaryTreeNode<int>> history;
+    history.reserve(copies + 1);
+    history.emplace_back(next++);
+    build_pointer_tree(history.back(), nodes, next);
+    const auto heap_before = heap_in_use();
+    const auto edit_ns = time_ns([&] {
+      for (std::size_t idx{0}; idx < copies; ++idx) {
+        auto* node = &history.emplace_back(history.back());
+        for (const auto side : random_path()) {
+          node = side == Tree::Side::kLeft ? &*node->GetLeftChild()
+                                           : &*node->GetRightChild();
+        }
+        node->SetValue(static_cast<int>(idx));
+      }
+    });
+    const auto bytes = heap_in_use() - heap_before;
+    std::cout << "deep copy\t"
+              << static_cast<double>(bytes) / static_cast<double>(copies)
+              << '\t' << edit_ns / static_cast<double>(copies) << '\n';
+  }
+}
+
+// Sum through each traversal order, against the hand written stack walk
+void bench_traversals(std::size_t nodes) {
+  int next{0};
+  BinaryTreeNode<int> root{next++};
+  build_pointer_tree(root, nodes, next);
+
+  const auto per_node = [nodes](double value) {
+    return value / static_cast<double>(nodes);
+  };
+  const auto run = [&](const char* label, auto&& range) {
+    const auto ns = time_ns([&] {
+      std::uint64_t sum{0};
+      for (const int value : range) {
+        sum += static_cast<std::uint64_t>(value);
+      }
+      g_sink = g_sink + sum;
+    });
+    std::cout << label << '\t' << per_node(ns) << '\n';
+  };
+
+  std::cout << "traversal of " << nodes << " nodes (ns per node)\n";
+  std::cout << "stack walk\t"
+            << per_node(time_ns(
+                   [&] { g_sink = g_sink + sum_pointer_tree(root); }))
+            << '\n';
+  run("pre-order", root.PreOrder());
+  run("in-order", root.InOrder());
+  run("post-order", root.PostOrder());
+  run("level-order", root.LevelOrder());
+}
+
+// A right leaning chain, which used to overflow the stack on copy and free
+void bench_skewed(std::size_t nodes) {
+  std::cout << "chain of " << nodes << " nodes (ns per node)\n";
+  BinaryTreeNode<int> root{0};
+  auto* tail = &root;
+  for (std::size_t idx{1}; idx < nodes; ++idx) {
+    tail = &*tail->SetRightChild(BinaryTreeNode<int>{static_cast<int>(idx)});
+  }
+  std::optional<BinaryTreeNode<int>> copy;
+  const auto copy_ns = time_ns([&] { copy.emplace(root); });
+  const auto free_ns = time_ns([&] { copy.reset(); });
+  std::cout << "copy\t" << copy_ns / static_cast<double>(nodes) << '\n';
+  std::cout << "free\t" << free_ns / static_cast<double>(nodes) << '\n';
+}
+
+void bench_parallel_reduce(std::size_t nodes) {
+  int next{0};
+  BinaryTreeNode<int> root{next++};
+  build_pointer_tree(root, nodes, next);
+  const auto reduce = [](std::uint64_t acc, const int& value) {
+    return acc + static_cast<std::uint64_t>(value);
+  };
+  const auto combine = [](std::uint64_t lhs, std::uint64_t rhs) {
+    return lhs + rhs;
+  };
+
+  std::cout << "parallel sum of " << nodes << " nodes\n";
+  std::cout << "threads\tms\tspeedup\n";
+  const auto sequential_ns =
+      time_ns([&] { g_sink = g_sink + sum_pointer_tree(root); });
+  std::cout << "seq\t" << sequential_ns / 1e6 << "\t1\n";
+  const auto max_threads =
+      std::max(4u, 2 * std::thread::hardware_concurrency());
+  for (unsigned threads{1}; threads <= max_threads; threads *= 2) {
+    WorkStealingPool pool{threads};
+    const auto ns = time_ns([&] {
+      g_sink = g_sink + ParallelReduce(pool, root, std::uint64_t{0}, reduce,
+                                       combine);
+    });
+    std::cout << threads << '\t' << ns / 1e6 << '\t' << sequential_ns / ns
+              << '\n';
+  }
+}
+
+// Balanced search tree over the even numbers 0, 2, ..., 2 * (count - 1)
+void build_search_tree(BinaryTreeNode<int>& node, std::size_t first,
+                       std::size_t count) {
+  const std::size_t left = count / 2;
+  const std::size_t right = count - left - 1;
+  node.SetValue(static_cast<int>(2 * (first + left)));
+  if (left > 0) {
+    auto& child = node.SetLeftChild(BinaryTreeNode<int>{0});
+    build_search_tree(*child, first, left);
+  }
+  if (right > 0) {
+    auto& child = node.SetRightChild(BinaryTreeNode<int>{0});
+    build_search_tree(*child, first + left + 1, right);
+  }
+}
+
+const int* pointer_lower_bound(const BinaryTreeNode<int>& root, int key) {
+  const int* found{nullptr};
+  for (const auto* node = &root; node != nullptr;) {
+    if (node->Value() < key) {
+      node = node->GetRightChildPtr();
+    } else {
+      found = &node->Value();
+      node = node->GetLeftChildPtr();
+    }
+  }
+  return found;
+}
+
+// Random lower bound queries, about half of them hits
+void bench_frozen_lookups(std::size_t nodes, std::size_t queries) {
+  BinaryTreeNode<int> root{0};
+  build_search_tree(root, 0, nodes);
+  const auto frozen = Freeze(root);
+  std::vector<int> sorted;
+  sorted.reserve(nodes);
+  for (const int value : root.InOrder()) {
+    sorted.push_back(value);
+  }
+
+  std::mt19937 rng{7};
+  std::uniform_int_distribution<int> dist{0, static_cast<int>(2 * nodes)};
+  std::vector<int> keys(queries);
+  for (auto& key : keys) {
+    key = dist(rng);
+  }
+  std::vector<const int*> results(queries);
+
+  const auto report = [queries](const char* label, double ns) {
+    std::cout << label << '\t' << static_cast<double>(queries) / ns * 1e3
+              << '\t' << ns / static_cast<double>(queries) << '\n';
+  };
+  const auto checksum = [&results] {
+    std::uint64_t sum{0};
+    for (const auto* found : results) {
+      sum += found != nullptr ? static_cast<std::uint64_t>(*found) : 1;
+    }
+    return sum;
+  };
+
+  std::cout << queries << " lower bound queries on " << nodes << " ints\n";
+  std::cout << "layout\tM lookups/s\tns per lookup\n";
+  report("pointer tree", time_ns([&] {
+           for (std::size_t idx{0}; idx < queries; ++idx) {
+             results[idx] = pointer_lower_bound(root, keys[idx]);
+           }
+         }));
+  const auto expected = checksum();
+  report("sorted vector", time_ns([&] {
+           for (std::size_t idx{0}; idx < queries; ++idx) {
+             const auto it =
+                 std::lower_bound(sorted.begin(), sorted.end(), keys[idx]);
+             results[idx] = it != sorted.end() ? &*it : nullptr;
+           }
+         }));
+  report("eytzinger", time_ns([&] {
+           for (std::size_t idx{0}; idx < queries; ++idx) {
+             results[idx] = frozen.LowerBound(keys[idx]);
+           }
+         }));
+  report("eytzinger batch",
+         time_ns([&] { frozen.LowerBound(keys, results); }));
+  if (checksum() != expected) {
+    std::cout << "mismatch between layouts\n";
+  }
+}
+
+// Walks either tree type through the shared read-only pointer accessors
+template <typename TNode>
+std::uint64_t sum_tree(const TNode* root) {
+  std::uint64_t sum{0};
+  std::vector<const TNode*> stack{root};
+  while (!stack.empty()) {
+    const auto* node = stack.back();
+    stack.pop_back();
+    sum += static_cast<std::uint64_t>(node->Value());
+    if (const auto* right = node->GetRightChildPtr()) {
+      stack.push_back(right);
+    }
+    if (const auto* left = node->GetLeftChildPtr()) {
+      stack.push_back(left);
+    }
+  }
+  return sum;
+}
+
+// Time to a usable tree: rebuilding node by node against mapping the file
+void bench_mapped_startup(std::size_t nodes) {
+  const auto path =
+      (std::filesystem::temp_directory_path() / "tree_bench.mgt").string();
+  std::cout << "startup with " << nodes << " nodes (ms)\n";
+
+  std::optional<BinaryTreeNode<int>> built;
+  const auto rebuild_ns = time_ns([&] {
+    int next{0};
+    built.emplace(next++);
+    build_pointer_tree(*built, nodes, next);
+  });
+  const auto write_ns = time_ns([&] { WriteMappedTree(*built, path); });
+  const auto expected = sum_tree(&*built);
+  built.reset();
+
+  std::optional<MappedBinaryTree<int>> mapped;
+  const auto open_ns = time_ns([&] { mapped.emplace(path); });
+  std::uint64_t sum{0};
+  const auto first_walk_ns = time_ns([&] { sum = sum_tree(mapped->Root()); });
+  const auto walk_ns =
+      time_ns([&] { g_sink = g_sink + sum_tree(mapped->Root()); });
+
+  std::cout << "rebuild\t" << rebuild_ns / 1e6 << '\n';
+  std::cout << "write file\t" << write_ns / 1e6 << '\n';
+  std::cout << "open mapped\t" << open_ns / 1e6 << '\n';
+  std::cout << "first walk of mapped\t" << first_walk_ns / 1e6 << '\n';
+  std::cout << "warm walk of mapped\t" << walk_ns / 1e6 << '\n';
+  if (sum != expected) {
+    std::cout << "mapped tree does not match\n";
+  }
+  mapped.reset();
+  std::filesystem::remove(path);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t nodes = argc > 1 ? std::stoul(argv[1]) : 10'000'000;
+  bench_layouts(nodes);
+  bench_free_list(nodes);
+  bench_versions(nodes, argc > 2 ? std::stoul(argv[2]) : 100'000);
+  bench_traversals(nodes);
+  bench_skewed(nodes);
+  bench_parallel_reduce(nodes);
+  bench_frozen_lookups(nodes, 10'000'000);
+  bench_mapped_startup(nodes);
+}
@@ -0,0 +1,404 @@
+/**
+ * @brief Fork-join aggregation over BinaryTreeNode on a work-stealing pool
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef TREE_PARALLEL_HPP
+#define TREE_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <forward_list>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tree.hpp"
+
+/**
+ * @brief Fixed set of workers, each with its own deque of tasks
+ *
+ * A worker pushes and pops tasks at the back of its own deque and, when that
+ * runs dry, steals from the front of the others'. Tasks are spawned into a
+ * TaskGroup and joined with Wait, which runs pending tasks while it waits
+ * rather than blocking, so a task may wait on tasks it spawned. Wait can also
+ * be called from a thread outside the pool, which then helps until its group
+ * is done.
+ */
+class WorkStealingPool {
+public:
+  class TaskGroup {
+  public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+  private:
+    friend class WorkStealingPool;
+
+    std::atomic<std::size_t> m_pending{0};
+    std::mutex m_error_mutex;
+    std::exception_ptr m_error;
+  };
+
+  explicit WorkStealingPool(
+      std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+      : m_queues(std::max<std::size_t>(threads, 1)) {
+    for (auto& queue : m_queues) {
+      queue = std::make_unique<Queue>();
+    }
+    m_workers.reserve(m_queues.size());
+    for (std::size_t idx{0}; idx < m_queues.size(); ++idx) {
+      m_workers.emplace_back([this, idx] { WorkerLoop(idx); });
+    }
+  }
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard lock{m_sleep_mutex};
+      m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  [[nodiscard]] std::size_t Size() const noexcept { return m_queues.size(); }
+
+  // Queue func on the calling worker's deque, or on a random one from outside
+  template <typename TFunc>
+  void Spawn(TaskGroup& group, TFunc&& func) {
+    Task task{[&group, func = std::forward<TFunc>(func)]() mutable {
+      try {
+        func();
+      } catch (...) {
+        std::lock_guard lock{group.m_error_mutex};
+        if (!group.m_error) {
+          group.m_error = std::current_exception();
+        }
+      }
+      group.m_pending.fetch_sub(1, std::memory_order_release);
+    }};
+    auto home = tl_index;
+    if (tl_pool != this) {
+      home = m_next_outside.fetch_add(1, std::memory_order_relaxed);
+      home %= m_queues.size();
+    }
+    // Counted before it is queued, since another worker may run it at once;
+    // taken back if queueing fails, or Wait would never see the group finish
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+    try {
+      std::lock_guard lock{m_queues[home]->mutex};
+      m_queues[home]->tasks.push_back(std::move(task));
+    } catch (...) {
+      group.m_pending.fetch_sub(1, std::memory_order_relaxed);
+      throw;
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+      // A worker between checking for work and sleeping would miss the wake
+      std::lock_guard lock{m_sleep_mutex};
+    }
+    m_wake.notify_one();
+  }
+
+  // Run queued tasks until every task spawned into group has finished
+  void Wait(TaskGroup& group) {
+    const auto home = tl_pool == this ? tl_index : 0;
+    while (group.m_pending.load(std::memory_order_acquire) != 0) {
+      if (!RunOne(home)) {
+        std::this_thread::yield();
+      }
+    }
+    if (group.m_error) {
+      std::rethrow_exception(std::exchange(group.m_error, nullptr));
+    }
+  }
+
+private:
+  using Task = std::function<void()>;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool RunOne(std::size_t home) {
+    Task task;
+    if (!Pop(home, task)) {
+      return false;
+    }
+    task();
+    return true;
+  }
+
+  // Newest task from home, else the oldest task of any other queue
+  bool Pop(std::size_t home, Task& task) {
+    if (m_queued.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    {
+      auto& queue = *m_queues[home];
+      std::lock_guard lock{queue.mutex};
+      if (!queue.tasks.empty()) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    for (std::size_t offset{1}; offset < m_queues.size(); ++offset) {
+      auto& queue = *m_queues[(home + offset) % m_queues.size()];
+      std::lock_guard lock{queue.mutex};
+      if (!queue.tasks.empty()) {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void WorkerLoop(std::size_t index) {
+    tl_pool = this;
+    tl_index = index;
+    while (true) {
+      if (RunOne(index)) {
+        continue;
+      }
+      std::unique_lock lock{m_sleep_mutex};
+      m_wake.wait(lock, [this] {
+        return m_stopping || m_queued.load(std::memory_order_acquire) != 0;
+      });
+      if (m_stopping) {
+        return;
+      }
+    }
+  }
+
+  static inline thread_local WorkStealingPool* tl_pool{nullptr};
+  static inline thread_local std::size_t tl_index{0};
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_workers;
+  std::atomic<std::size_t> m_queued{0};
+  std::atomic<std::size_t> m_next_outside{0};
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wake;
+  bool m_stopping{false};
+};
+
+namespace tree_parallel_detail {
+
+template <typename TValueType>
+using Node = BinaryTreeNode<TValueType>;
+
+// Call func on every value of the subtree, sequentially
+template <typename TValueType, typename TFunc>
+void ForEachSequential(const Node<TValueType>* root, TFunc& func) {
+  std::vector<const Node<TValueType>*> stack{root};
+  while (!stack.empty()) {
+    const auto* node = stack.back();
+    stack.pop_back();
+    func(node->Value());
+    if (const auto* right = node->GetRightChildPtr()) {
+      stack.push_back(right);
+    }
+    if (const auto* left = node->GetLeftChildPtr()) {
+      stack.push_back(left);
+    }
+  }
+}
+
+/**
+ * @brief Whether both subtrees have at least grain nodes
+ *
+ * Counts the two in lockstep and stops as soon as one runs out, so the cost
+ * is bounded by the smaller subtree (or by grain), never by the larger one.
+ * smaller is set to the subtree that ran out first.
+ */
+template <typename TValueType>
+bool BothAtLeast(const Node<TValueType>* lhs, const Node<TValueType>* rhs,
+                 std::size_t grain, const Node<TValueType>*& smaller) {
+  std::vector<const Node<TValueType>*> lhs_stack{lhs};
+  std::vector<const Node<TValueType>*> rhs_stack{rhs};
+  const auto step = [](std::vector<const Node<TValueType>*>& stack) {
+    const auto* node = stack.back();
+    stack.pop_back();
+    if (const auto* right = node->GetRightChildPtr()) {
+      stack.push_back(right);
+    }
+    if (const auto* left = node->GetLeftChildPtr()) {
+      stack.push_back(left);
+    }
+  };
+  for (std::size_t counted{0}; counted < grain; ++counted) {
+    if (lhs_stack.empty()) {
+      smaller = lhs;
+      return false;
+    }
+    if (rhs_stack.empty()) {
+      smaller = rhs;
+      return false;
+    }
+    step(lhs_stack);
+    step(rhs_stack);
+  }
+  return true;
+}
+
+/**
+ * @brief Walk the subtree, handing off child pairs that are large on both
+ * sides
+ *
+ * Of two children that both have at least grain nodes, the left one goes to
+ * fork(subtree, budget) and the walk continues into the right one. Otherwise
+ * the smaller goes to visit_subtree(subtree) and the walk continues into the
+ * larger. visit(value) is called on the nodes walked through.
+ *
+ * budget caps the number of forks below this walk; half of what is left
+ * travels with each fork. Once it is spent the rest of the subtree goes to
+ * visit_subtree, so sizing work stays proportional to the pool rather than
+ * to the tree.
+ */
+template <typename TValueType, typename TVisit, typename TVisitSubtree,
+          typename TFork>
+void SplitWalk(const Node<TValueType>* node, std::size_t grain,
+               std::size_t budget, TVisit& visit,
+               TVisitSubtree&& visit_subtree, TFork&& fork) {
+  while (node != nullptr) {
+    if (budget == 0) {
+      visit_subtree(node);
+      return;
+    }
+    visit(node->Value());
+    const auto* left = node->GetLeftChildPtr();
+    const auto* right = node->GetRightChildPtr();
+    if (left == nullptr || right == nullptr) {
+      node = left != nullptr ? left : right;
+      continue;
+    }
+    const Node<TValueType>* smaller{nullptr};
+    if (BothAtLeast(left, right, grain, smaller)) {
+      const auto forked_budget = budget / 2;
+      budget -= forked_budget + 1;
+      fork(left, forked_budget);
+      node = right;
+    } else {
+      visit_subtree(smaller);
+      node = smaller == left ? right : left;
+    }
+  }
+}
+
+}  // namespace tree_parallel_detail
+
+// Subtrees smaller than this are not worth a task
+inline constexpr std::size_t kDefaultTreeGrain{4096};
+// Tasks per worker, enough slack for stealing to even out uneven subtrees
+inline constexpr std::size_t kTreeTasksPerWorker{8};
+
+/**
+ * @brief Combine every value of the tree into one result
+ *
+ * Each task starts its partial result from init, folds values in with
+ * reduce(TResult, const TValueType&) and partial results are merged with
+ * combine(TResult, TResult). The visiting order is unspecified, so both need
+ * to be associative and commutative and init must be their identity. A
+ * moved-from root has no values and gives init.
+ */
+template <typename TValueType, typename TResult, typename TReduce,
+          typename TCombine>
+TResult ParallelReduce(WorkStealingPool& pool,
+                       const BinaryTreeNode<TValueType>& root, TResult init,
+                       TReduce reduce, TCombine combine,
+                       std::size_t grain = kDefaultTreeGrain) {
+  using Node = BinaryTreeNode<TValueType>;
+  // Every task owns one partial result; forward_list keeps them in place
+  const std::function<TResult(const Node*, std::size_t)> reduce_task =
+      [&](const Node* subtree, std::size_t budget) {
+        TResult acc = init;
+        std::forward_list<TResult> forked;
+        WorkStealingPool::TaskGroup group;
+        auto fold = [&](const TValueType& value) {
+          acc = reduce(std::move(acc), value);
+        };
+        try {
+          tree_parallel_detail::SplitWalk<TValueType>(
+              subtree, grain, budget, fold,
+              [&](const Node* small) {
+                tree_parallel_detail::ForEachSequential<TValueType>(small,
+                                                                    fold);
+              },
+              [&](const Node* big, std::size_t big_budget) {
+                auto& slot = forked.emplace_front(init);
+                pool.Spawn(group, [&reduce_task, &slot, big, big_budget] {
+                  slot = reduce_task(big, big_budget);
+                });
+              });
+        } catch (...) {
+          // Forked tasks still reference this frame
+          pool.Wait(group);
+          throw;
+        }
+        pool.Wait(group);
+        for (auto& partial : forked) {
+          acc = combine(std::move(acc), std::move(partial));
+        }
+        return acc;
+      };
+  if (!root.HasValue()) {
+    return init;
+  }
+  return reduce_task(&root, kTreeTasksPerWorker * pool.Size());
+}
+
+/**
+ * @brief Call func(const TValueType&) on every value of the tree, in no
+ * particular order and possibly from several threads at once
+ */
+template <typename TValueType, typename TFunc>
+void ParallelForEach(WorkStealingPool& pool,
+                     const BinaryTreeNode<TValueType>& root, TFunc func,
+                     std::size_t grain = kDefaultTreeGrain) {
+  using Node = BinaryTreeNode<TValueType>;
+  const std::function<void(const Node*, std::size_t)> for_each_task =
+      [&](const Node* subtree, std::size_t budget) {
+        WorkStealingPool::TaskGroup group;
+        try {
+          tree_parallel_detail::SplitWalk<TValueType>(
+              subtree, grain, budget, func,
+              [&](const Node* small) {
+                tree_parallel_detail::ForEachSequential<TValueType>(small,
+                                                                    func);
+              },
+              [&](const Node* big, std::size_t big_budget) {
+                pool.Spawn(group, [&for_each_task, big, big_budget] {
+                  for_each_task(big, big_budget);
+                });
+              });
+        } catch (...) {
+          pool.Wait(group);
+          throw;
+        }
+        pool.Wait(group);
+      };
+  if (root.HasValue()) {
+    for_each_task(&root, kTreeTasksPerWorker * pool.Size());
+  }
+}
+
+#endif  // TREE_PARALLEL_HPP
@@ -0,0 +1,605 @@
+/**
+ * @brief Columnar, compressed archive of log records, and a sink that
+ * writes one
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef LOG_ARCHIVE_HPP
+#define LOG_ARCHIVE_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "logger2.hpp"
+
+/**
+ * File layout: a LogArchiveFileHeader, then blocks of up to block_records
+ * records. Each block is a LogArchiveBlockHeader followed by its columns, in
+ * this order:
+ *
+ *   times     first time as a varint offset from min_time, then zigzag
+ *             varint deltas between neighbouring records (nanoseconds)
+ *   levels    one byte per record
+ *   sites     the block's call site dictionary (count, then line, file and
+ *             function of each), then one varint per record: 0 for no
+ *             source location, otherwise dictionary index + 1
+ *   messages  varint length and bytes of every message, compressed as one
+ *             stream with lz_compress
+ *
+ * The block header carries the time range, the set of levels present and the
+ * size of every column, so a reader can skip a block, or everything after its
+ * levels column, without decoding it.
+ */
+namespace log_archive_detail {
+
+inline void put_varint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+[[nodiscard]] inline std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^
+           static_cast<std::uint64_t>(value >> 63);
+}
+
+[[nodiscard]] inline std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^
+           -static_cast<std::int64_t>(value & 1);
+}
+
+[[noreturn]] inline void corrupt() {
+    throw std::runtime_error("LogArchiveReader: corrupt block");
+}
+
+// Bounds checked cursor over one decoded column
+struct ByteReader {
+    const char* pos;
+    const char* end;
+
+    [[nodiscard]] std::uint64_t varint() {
+        std::uint64_t value{0};
+        for (int shift{0}; shift < 64; shift += 7) {
+            if (pos == end) {
+                corrupt();
+            }
+            const auto byte = static_cast<std::uint8_t>(*pos++);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        corrupt();
+    }
+
+    [[nodiscard]] std::string_view bytes(std::uint64_t size) {
+        if (size > static_cast<std::uint64_t>(end - pos)) {
+            corrupt();
+        }
+        const std::string_view view{pos, static_cast<std::size_t>(size)};
+        pos += size;
+        return view;
+    }
+};
+
+inline constexpr std::size_t kMinMatch{4};
+inline constexpr std::size_t kMaxOffset{65535};
+inline constexpr int kHashBits{14};
+
+[[nodiscard]] inline std::uint32_t load32(const char* ptr) {
+    std::uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+[[nodiscard]] inline std::uint32_t hash4(const char* ptr) {
+    return (load32(ptr) * 2654435761u) >> (32 - kHashBits);
+}
+
+/**
+ * Small LZ77 codec. The output is a run of sequences, each a varint literal
+ * count, that many literal bytes, then - unless the input ends there - a
+ * varint match length minus kMinMatch and a varint offset back into the
+ * output. Matches are found through a single-entry hash table of 4-byte
+ * prefixes, which is enough for log messages built from a few templates.
+ */
+[[nodiscard]] inline std::string lz_compress(std::string_view input) {
+    std::string out;
+    out.reserve(input.size() / 2 + 16);
+    std::vector<std::uint32_t> table(std::size_t{1} << kHashBits, 0);
+    const char* const base = input.data();
+    const std::size_t size{input.size()};
+    std::size_t anchor{0};
+    std::size_t pos{0};
+
+    while (pos + kMinMatch <= size) {
+        const std::uint32_t hash{hash4(base + pos)};
+        // Entries hold position + 1 so that 0 means empty
+        const std::size_t candidate{table[hash]};
+        table[hash] = static_cast<std::uint32_t>(pos + 1);
+        if (candidate == 0 || pos + 1 - candidate > kMaxOffset ||
+            load32(base + candidate - 1) != load32(base + pos)) {
+            ++pos;
+            continue;
+        }
+        const std::size_t match{candidate - 1};
+        std::size_t length{kMinMatch};
+        while (pos + length < size &&
+               base[match + length] == base[pos + length]) {
+            ++length;
+        }
+        put_varint(out, pos - anchor);
+        out.append(base + anchor, pos - anchor);
+        put_varint(out, length - kMinMatch);
+        put_varint(out, pos - match);
+        pos += length;
+        anchor = pos;
+    }
+    put_varint(out, size - anchor);
+    out.append(base + anchor, size - anchor);
+    return out;
+}
+
+[[nodiscard]] inline std::string lz_decompress(std::string_view input,
+                                               std::size_t size) {
+    std::string out;
+    out.resize(size);
+    ByteReader reader{input.data(), input.data() + input.size()};
+    std::size_t pos{0};
+    while (true) {
+        const std::uint64_t literals{reader.varint()};
+        if (literals > size - pos) {
+            corrupt();
+        }
+        std::memcpy(out.data() + pos, reader.bytes(literals).data(), literals);
+        pos += literals;
+        if (pos == size) {
+            break;
+        }
+        const std::uint64_t length{reader.varint() + kMinMatch};
+        const std::uint64_t offset{reader.varint()};
+        if (offset == 0 || offset > pos || length > size - pos) {
+            corrupt();
+        }
+        if (offset >= length) {
+            std::memcpy(out.data() + pos, out.data() + pos - offset, length);
+            pos += length;
+            continue;
+        }
+        // Byte by byte, since the match overlaps the bytes it produces
+        for (std::size_t index{0}; index < length; ++index, ++pos) {
+            out[pos] = out[pos - offset];
+        }
+    }
+    if (reader.pos != reader.end) {
+        corrupt();
+    }
+    return out;
+}
+
+}  // namespace log_archive_detail
+
+struct LogArchiveFileHeader {
+    std::array<char, 8> magic{'M', 'G', 'L', 'O', 'G', 'A', 'R', '\0'};
+    std::uint32_t version{1};
+    std::uint32_t byte_order{0x01020304};
+};
+
+struct LogArchiveBlockHeader {
+    std::int64_t min_time{0};
+    std::int64_t max_time{0};
+    std::uint32_t records{0};
+    std::uint32_t times_size{0};
+    std::uint32_t levels_size{0};
+    std::uint32_t sites_size{0};
+    std::uint32_t messages_size{0};
+    std::uint32_t messages_raw_size{0};
+    // Bit n is set when the block holds a record of LogLevel n
+    std::uint32_t level_mask{0};
+    std::uint32_t magic{0x4b4c4247};
+};
+
+/**
+ * Log sink that writes a LogArchive file. It takes LogRecords rather than
+ * formatted lines, so nothing is parsed back out of the text; records are
+ * buffered per column and a block is encoded every block_records records and
+ * when the sink is flushed or destroyed.
+ *
+ * It can't be copied, so hand it to Logger::add_sink as std::ref(sink) and
+ * keep it alive for as long as the logger may log to it.
+ */
+class LogArchiveSink {
+   public:
+    explicit LogArchiveSink(const std::string& path,
+                            std::size_t block_records = 4096)
+        : m_out{path, std::ios::binary | std::ios::trunc},
+          m_block_records{block_records == 0 ? 1 : block_records} {
+        if (!m_out) {
+            throw std::runtime_error("LogArchiveSink: cannot open " + path);
+        }
+        const LogArchiveFileHeader header{};
+        m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_written = sizeof(header);
+    }
+
+    LogArchiveSink(const LogArchiveSink&) = delete;
+    LogArchiveSink& operator=(const LogArchiveSink&) = delete;
+
+    ~LogArchiveSink() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    void log(const LogRecord& record) {
+        using namespace log_archive_detail;
+        m_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              record.time.time_since_epoch())
+                              .count());
+        m_levels.push_back(static_cast<char>(record.level));
+        m_sites.push_back(site_id(record.src_loc));
+        put_varint(m_messages, record.message.size());
+        m_messages.append(record.message);
+        if (m_times.size() >= m_block_records) {
+            write_block();
+        }
+    }
+
+    // Encodes whatever is buffered as a (short) block
+    void flush() {
+        if (!m_times.empty()) {
+            write_block();
+        }
+        m_out.flush();
+    }
+
+    // Bytes handed to the file so far, not counting buffered records
+    [[nodiscard]] std::size_t bytes_written() const { return m_written; }
+
+   private:
+    struct Site {
+        const char* file;
+        const char* function;
+        std::uint32_t line;
+        bool operator==(const Site&) const = default;
+    };
+    struct SiteHash {
+        std::size_t operator()(const Site& site) const {
+            return std::hash<const void*>{}(site.file) * 31 +
+                   std::hash<const void*>{}(site.function) * 17 + site.line;
+        }
+    };
+
+    std::ofstream m_out;
+    std::size_t m_block_records;
+    std::size_t m_written{0};
+    std::vector<std::int64_t> m_times;
+    std::string m_levels;
+    std::vector<std::uint32_t> m_sites;
+    std::string m_messages;
+    // The block's dictionary; source_location strings are static, so the
+    // pointers identify a call site without comparing text
+    std::unordered_map<Site, std::uint32_t, SiteHash> m_site_ids;
+    std::vector<Site> m_site_list;
+
+    std::uint32_t site_id(const std::source_location* src_loc) {
+        if (src_loc == nullptr) {
+            return 0;
+        }
+        const Site site{src_loc->file_name(), src_loc->function_name(),
+                        src_loc->line()};
+        const auto [it, inserted] = m_site_ids.try_emplace(
+            site, static_cast<std::uint32_t>(m_site_list.size() + 1));
+        if (inserted) {
+            m_site_list.push_back(site);
+        }
+        return it->second;
+    }
+
+    void write_block() {
+        using namespace log_archive_detail;
+        LogArchiveBlockHeader header{};
+        header.records = static_cast<std::uint32_t>(m_times.size());
+        header.min_time = std::numeric_limits<std::int64_t>::max();
+        header.max_time = std::numeric_limits<std::int64_t>::min();
+        for (const std::int64_t time : m_times) {
+            header.min_time = std::min(header.min_time, time);
+            header.max_time = std::max(header.max_time, time);
+        }
+        for (const char level : m_levels) {
+            header.level_mask |= 1u << static_cast<unsigned>(level);
+        }
+
+        std::string times;
+        put_varint(times, static_cast<std::uint64_t>(m_times.front() -
+                                                     header.min_time));
+        for (std::size_t index{1}; index < m_times.size(); ++index) {
+            put_varint(times, zigzag(m_times[index] - m_times[index - 1]));
+        }
+
+        std::string sites;
+        put_varint(sites, m_site_list.size());
+        for (const Site& site : m_site_list) {
+            const std::string_view file{site.file};
+            const std::string_view function{site.function};
+            put_varint(sites, site.line);
+            put_varint(sites, file.size());
+            sites.append(file);
+            put_varint(sites, function.size());
+            sites.append(function);
+        }
+        for (const std::uint32_t site : m_sites) {
+            put_varint(sites, site);
+        }
+
+        const std::string messages{lz_compress(m_messages)};
+
+        header.times_size = static_cast<std::uint32_t>(times.size());
+        header.levels_size = static_cast<std::uint32_t>(m_levels.size());
+        header.sites_size = static_cast<std::uint32_t>(sites.size());
+        header.messages_size = static_cast<std::uint32_t>(messages.size());
+        header.messages_raw_size =
+            static_cast<std::uint32_t>(m_messages.size());
+
+        m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_out.write(times.data(), static_cast<std::streamsize>(times.size()));
+        m_out.write(m_levels.data(),
+                    static_cast<std::streamsize>(m_levels.size()));
+        m_out.write(sites.data(), static_cast<std::streamsize>(sites.size()));
+        m_out.write(messages.data(),
+                    static_cast<std::streamsize>(messages.size()));
+        if (!m_out) {
+            throw std::runtime_error("LogArchiveSink: write failed");
+        }
+        m_written += sizeof(header) + times.size() + m_levels.size() +
+                     sites.size() + messages.size();
+
+        m_times.clear();
+        m_levels.clear();
+        m_sites.clear();
+        m_messages.clear();
+        m_site_ids.clear();
+        m_site_list.clear();
+    }
+};
+
+// Records from is inclusive and to exclusive; levels below min_level are
+// left out
+struct LogArchiveFilter {
+    std::chrono::system_clock::time_point from{
+        std::chrono::system_clock::time_point::min()};
+    std::chrono::system_clock::time_point to{
+        std::chrono::system_clock::time_point::max()};
+    LogLevel min_level{LogLevel::debug};
+};
+
+// A record handed to LogArchiveReader's callback; the views are only valid
+// during the call. file and function are empty without a source location.
+struct ArchivedLogRecord {
+    std::chrono::system_clock::time_point time;
+    LogLevel level;
+    std::string_view file;
+    std::string_view function;
+    std::uint32_t line;
+    std::string_view message;
+};
+
+// What a scan touched, to show how much of the file a filter let it skip
+struct LogArchiveScan {
+    std::size_t records{0};
+    std::size_t blocks{0};
+    std::size_t blocks_skipped{0};
+    std::size_t messages_decoded{0};
+};
+
+/**
+ * Streams a LogArchive file one block at a time. A block whose header rules
+ * out the filter is skipped unread; otherwise only the times and levels
+ * columns are decoded, and the sites and messages columns are read and
+ * decompressed only if some record of the block matched.
+ */
+class LogArchiveReader {
+   public:
+    explicit LogArchiveReader(const std::string& path)
+        : m_in{path, std::ios::binary} {
+        if (!m_in) {
+            throw std::runtime_error("LogArchiveReader: cannot open " + path);
+        }
+        LogArchiveFileHeader header{};
+        m_in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        const LogArchiveFileHeader expected{};
+        if (!m_in || header.magic != expected.magic ||
+            header.version != expected.version) {
+            throw std::runtime_error("LogArchiveReader: not a log archive " +
+                                     path);
+        }
+        if (header.byte_order != expected.byte_order) {
+            throw std::runtime_error(
+                "LogArchiveReader: written with another byte order " + path);
+        }
+        m_data_start = m_in.tellg();
+    }
+
+    // Calls func with every matching record, oldest block first
+    template <typename Func>
+    LogArchiveScan for_each(const LogArchiveFilter& filter, Func&& func) {
+        using namespace log_archive_detail;
+        using std::chrono::nanoseconds;
+        using std::chrono::system_clock;
+        const std::int64_t from{to_nanoseconds(filter.from)};
+        const std::int64_t to{to_nanoseconds(filter.to)};
+        const auto min_level = static_cast<std::uint32_t>(filter.min_level);
+        const std::uint32_t wanted_levels{~((1u << min_level) - 1)};
+
+        // Measured per scan, since the sink may still be appending blocks
+        m_in.clear();
+        m_in.seekg(0, std::ios::end);
+        m_file_size = m_in.tellg();
+        m_in.seekg(m_data_start);
+        LogArchiveScan scan{};
+        LogArchiveBlockHeader header{};
+        std::vector<std::int64_t> times;
+        std::vector<std::uint32_t> matches;
+        std::vector<ArchivedLogRecord> sites;
+        std::string times_column;
+        std::string levels;
+        std::string site_column;
+        std::string compressed;
+
+        while (m_in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            if (header.magic != LogArchiveBlockHeader{}.magic) {
+                corrupt();
+            }
+            ++scan.blocks;
+            const std::uint64_t rest{std::uint64_t{header.times_size} +
+                                     header.levels_size + header.sites_size +
+                                     header.messages_size};
+            if (header.max_time < from || header.min_time >= to ||
+                (header.level_mask & wanted_levels) == 0) {
+                ++scan.blocks_skipped;
+                skip(rest);
+                continue;
+            }
+
+            read_column(times_column, header.times_size);
+            ByteReader reader{times_column.data(),
+                              times_column.data() + times_column.size()};
+            times.resize(header.records);
+            std::int64_t time{header.min_time};
+            for (std::uint32_t index{0}; index < header.records; ++index) {
+                const std::uint64_t value{reader.varint()};
+                time = index == 0 ? header.min_time +
+                                        static_cast<std::int64_t>(value)
+                                  : time + unzigzag(value);
+                times[index] = time;
+            }
+
+            read_column(levels, header.levels_size);
+            if (levels.size() != header.records) {
+                corrupt();
+            }
+            matches.clear();
+            for (std::uint32_t index{0}; index < header.records; ++index) {
+                const auto level = static_cast<std::uint8_t>(levels[index]);
+                if (level >= min_level &&
+                    level < static_cast<std::uint8_t>(LogLevel::disabled) &&
+                    times[index] >= from && times[index] < to) {
+                    matches.push_back(index);
+                }
+            }
+            if (matches.empty()) {
+                ++scan.blocks_skipped;
+                skip(std::uint64_t{header.sites_size} + header.messages_size);
+                continue;
+            }
+
+            read_column(site_column, header.sites_size);
+            ByteReader site_reader{site_column.data(),
+                                   site_column.data() + site_column.size()};
+            sites.assign(1, ArchivedLogRecord{});
+            const std::uint64_t site_count{site_reader.varint()};
+            for (std::uint64_t index{0}; index < site_count; ++index) {
+                ArchivedLogRecord site{};
+                site.line = static_cast<std::uint32_t>(site_reader.varint());
+                site.file = site_reader.bytes(site_reader.varint());
+                site.function = site_reader.bytes(site_reader.varint());
+                sites.push_back(site);
+            }
+
+            read_column(compressed, header.messages_size);
+            const std::string messages{
+                lz_decompress(compressed, header.messages_raw_size)};
+            ++scan.messages_decoded;
+            ByteReader message_reader{messages.data(),
+                                      messages.data() + messages.size()};
+
+            std::size_t next_match{0};
+            for (std::uint32_t index{0}; index < header.records; ++index) {
+                const std::uint64_t site{site_reader.varint()};
+                const std::string_view message{
+                    message_reader.bytes(message_reader.varint())};
+                if (next_match == matches.size() ||
+                    matches[next_match] != index) {
+                    continue;
+                }
+                ++next_match;
+                if (site >= sites.size()) {
+                    corrupt();
+                }
+                ArchivedLogRecord record{sites[site]};
+                record.time = system_clock::time_point{
+                    std::chrono::duration_cast<system_clock::duration>(
+                        nanoseconds{times[index]})};
+                record.level = static_cast<LogLevel>(levels[index]);
+                record.message = message;
+                func(record);
+                ++scan.records;
+            }
+        }
+        if (!m_in.eof() || m_in.gcount() != 0) {
+            corrupt();
+        }
+        return scan;
+    }
+
+   private:
+    std::ifstream m_in;
+    std::streampos m_data_start{};
+    std::streampos m_file_size{};
+
+    [[nodiscard]] static std::int64_t to_nanoseconds(
+        std::chrono::system_clock::time_point time) {
+        using std::chrono::nanoseconds;
+        // The default bounds would overflow a nanosecond count
+        constexpr auto limit = std::chrono::duration_cast<
+            std::chrono::system_clock::duration>(nanoseconds::max());
+        if (time.time_since_epoch() >= limit) {
+            return std::numeric_limits<std::int64_t>::max();
+        }
+        if (time.time_since_epoch() <= -limit) {
+            return std::numeric_limits<std::int64_t>::min();
+        }
+        return std::chrono::duration_cast<nanoseconds>(time.time_since_epoch())
+            .count();
+    }
+
+    void read_column(std::string& column, std::uint32_t size) {
+        column.resize(size);
+        if (!m_in.read(column.data(), size)) {
+            log_archive_detail::corrupt();
+        }
+    }
+
+    // Seeking past the end succeeds, so a block cut short by truncation is
+    // caught by comparing against the file size instead
+    void skip(std::uint64_t size) {
+        const std::streampos position{m_in.tellg()};
+        if (position < 0 ||
+            size > static_cast<std::uint64_t>(m_file_size - position)) {
+            log_archive_detail::corrupt();
+        }
+        m_in.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+        if (!m_in) {
+            log_archive_detail::corrupt();
+        }
+    }
+};
+
+#endif  // LOG_ARCHIVE_HPP
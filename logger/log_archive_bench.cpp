@@ -0,0 +1,289 @@
+#include <fmt/compile.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_archive.hpp"
+#include "logger2.hpp"
+
+namespace {
+
+// Keeps the optimizer from discarding the work being measured
+volatile std::uint64_t g_sink{0};
+
+// What a plain log file costs: every line as DefaultFormatter wrote it
+struct TextFileSink {
+    explicit TextFileSink(const std::string& path)
+        : m_out{path, std::ios::binary | std::ios::trunc} {}
+    void log(std::string_view line) {
+        m_out.write(line.data(), static_cast<std::streamsize>(line.size()));
+        m_out.put('\n');
+    }
+    void flush() { m_out.flush(); }
+    std::ofstream m_out;
+};
+
+// Formats and drops, for the cost every sink pays before it sees the line
+struct CountingSink {
+    void log(std::string_view line) { m_bytes += line.size() + 1; }
+    std::size_t m_bytes{0};
+};
+
+// Keeps every field a sink is given, to check what the archive reads back
+struct RecordingSink {
+    struct Entry {
+        std::chrono::system_clock::time_point time;
+        LogLevel level;
+        std::string file;
+        std::string function;
+        std::uint32_t line;
+        std::string message;
+    };
+    void log(const LogRecord& record) {
+        const auto* src_loc = record.src_loc;
+        m_entries.push_back({record.time, record.level,
+                             src_loc != nullptr ? src_loc->file_name() : "",
+                             src_loc != nullptr ? src_loc->function_name() : "",
+                             src_loc != nullptr ? src_loc->line() : 0,
+                             std::string{record.message}});
+    }
+    std::vector<Entry> m_entries;
+};
+
+struct XorShift {
+    std::uint64_t state{0x9e3779b97f4a7c15};
+    std::uint64_t operator()() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+// A service's worth of lines: a handful of call sites, mostly debug and info,
+// with ids, addresses and durations that change from line to line
+template <typename TLogger>
+void write_lines(TLogger& logger, std::size_t lines) {
+    XorShift rng;
+    for (std::size_t line{0}; line < lines; ++line) {
+        const std::uint64_t roll{rng()};
+        const std::uint64_t value{rng()};
+        const std::uint64_t bucket{roll % 200};
+        if (bucket == 0) {
+            logger.with_ctx().critical(
+                FMT_COMPILE("disk usage {}% on /var/lib/data{}"),
+                95 + value % 5, value % 4);
+        } else if (bucket < 10) {
+            logger.with_ctx().error(
+                FMT_COMPILE("upstream timeout after {} ms, retry {}/3"),
+                1000 + value % 4000, 1 + value % 3);
+        } else if (bucket < 30) {
+            logger.with_ctx().warning(
+                FMT_COMPILE("slow query on shard {}: {:.1f} ms"), value % 16,
+                static_cast<double>(value % 100000) / 100.0);
+        } else if (bucket < 90) {
+            logger.with_ctx().debug(
+                FMT_COMPILE("cache hit for session {:016x}"), value);
+        } else if (bucket < 140) {
+            logger.with_ctx().info(
+                FMT_COMPILE("GET /api/v1/orders/{} 200 {}us"),
+                value % 1000000, 50 + (value >> 20) % 5000);
+        } else {
+            logger.with_ctx().info(
+                FMT_COMPILE("user {} logged in from 10.{}.{}.{}"),
+                value % 100000, (value >> 8) & 0xff, (value >> 16) & 0xff,
+                (value >> 24) & 0xff);
+        }
+    }
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+void print_ingest(const char* label, double seconds, std::size_t lines,
+                  std::size_t text_bytes, std::size_t file_bytes) {
+    std::cout << label << '\t' << seconds * 1e9 / static_cast<double>(lines)
+              << '\t' << static_cast<double>(text_bytes) / seconds / 1e6 << '\t'
+              << file_bytes << '\t'
+              << static_cast<double>(text_bytes) /
+                     static_cast<double>(file_bytes)
+              << '\n';
+}
+
+void print_query(const char* label, double seconds, std::size_t matched,
+                 const LogArchiveScan* scan) {
+    std::cout << label << '\t' << seconds * 1e3 << '\t' << matched;
+    if (scan != nullptr) {
+        std::cout << '\t' << scan->blocks << '\t' << scan->blocks_skipped
+                  << '\t' << scan->messages_decoded;
+    }
+    std::cout << '\n';
+}
+
+// Level is the second '|' separated field of a DefaultFormatter line
+std::size_t grep_levels(const std::string& path, LogLevel min_level) {
+    std::ifstream in{path, std::ios::binary};
+    std::string line;
+    std::size_t matched{0};
+    while (std::getline(in, line)) {
+        const std::size_t start{line.find('|') + 1};
+        const std::string_view level{line.data() + start,
+                                     line.find('|', start) - start};
+        const bool keep =
+            (level == "Critical") ||
+            (min_level <= LogLevel::error && level == "Error") ||
+            (min_level <= LogLevel::warning && level == "Warning") ||
+            (min_level <= LogLevel::info && level == "Info") ||
+            (min_level <= LogLevel::debug && level == "Debug");
+        if (keep) {
+            g_sink = g_sink + line.size();
+            ++matched;
+        }
+    }
+    return matched;
+}
+
+// Logs lines into an archive and a RecordingSink at once, then reads the
+// archive back and compares every field of every record
+bool archive_round_trips(const std::string& path, std::size_t lines) {
+    RecordingSink recording;
+    {
+        Logger<> logger;
+        LogArchiveSink archive{path};
+        logger.remove_sink("default");
+        logger.add_sink("archive", std::ref(archive));
+        logger.add_sink("recording", std::ref(recording));
+        write_lines(logger, lines);
+        logger.info(FMT_COMPILE("and one without a source location"));
+    }
+    LogArchiveReader reader{path};
+    std::size_t index{0};
+    bool same{true};
+    reader.for_each({}, [&](const ArchivedLogRecord& record) {
+        if (index >= recording.m_entries.size()) {
+            same = false;
+            return;
+        }
+        const auto& expected = recording.m_entries[index++];
+        same = same && record.time == expected.time &&
+               record.level == expected.level &&
+               record.file == expected.file &&
+               record.function == expected.function &&
+               record.line == expected.line &&
+               record.message == expected.message;
+    });
+    std::filesystem::remove(path);
+    return same && index == recording.m_entries.size();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t lines = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string text_path{(dir / "log_archive_bench.log").string()};
+    const std::string archive_path{(dir / "log_archive_bench.lar").string()};
+
+    if (!archive_round_trips(archive_path, lines)) {
+        std::cerr << "archive did not read back what was logged\n";
+        return 1;
+    }
+
+    std::size_t text_bytes{0};
+    {
+        Logger<> logger;
+        CountingSink counting;
+        logger.remove_sink("default");
+        logger.add_sink("count", std::ref(counting));
+        const auto start = std::chrono::steady_clock::now();
+        write_lines(logger, lines);
+        const double seconds{seconds_since(start)};
+        text_bytes = counting.m_bytes;
+        std::cout << "\tns per line\ttext MB/s\tfile bytes\tratio\n";
+        print_ingest("format only", seconds, lines, text_bytes, text_bytes);
+    }
+    {
+        Logger<> logger;
+        TextFileSink text{text_path};
+        logger.remove_sink("default");
+        logger.add_sink("text", std::ref(text));
+        const auto start = std::chrono::steady_clock::now();
+        write_lines(logger, lines);
+        text.flush();
+        const double seconds{seconds_since(start)};
+        print_ingest("text file", seconds, lines, text_bytes,
+                     std::filesystem::file_size(text_path));
+    }
+    const auto first = std::chrono::system_clock::now();
+    {
+        Logger<> logger;
+        LogArchiveSink archive{archive_path};
+        logger.remove_sink("default");
+        logger.add_sink("archive", std::ref(archive));
+        const auto start = std::chrono::steady_clock::now();
+        write_lines(logger, lines);
+        archive.flush();
+        const double seconds{seconds_since(start)};
+        print_ingest("archive", seconds, lines, text_bytes,
+                     std::filesystem::file_size(archive_path));
+    }
+    const auto last = std::chrono::system_clock::now();
+
+    LogArchiveReader reader{archive_path};
+    auto scan_archive = [&](const char* label, const LogArchiveFilter& filter) {
+        std::size_t matched{0};
+        const auto start = std::chrono::steady_clock::now();
+        const LogArchiveScan scan{
+            reader.for_each(filter, [&](const ArchivedLogRecord& record) {
+                g_sink = g_sink + record.message.size();
+                ++matched;
+            })};
+        print_query(label, seconds_since(start), matched, &scan);
+        return matched;
+    };
+
+    std::cout << "\nquery\tms\trecords\tblocks\tskipped\tmessages decoded\n";
+    if (scan_archive("archive, everything", {}) != lines) {
+        std::cerr << "archive lost records\n";
+        return 1;
+    }
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t matched{grep_levels(text_path, LogLevel::debug)};
+        print_query("text, everything", seconds_since(start), matched,
+                    nullptr);
+    }
+    {
+        LogArchiveFilter filter{};
+        filter.min_level = LogLevel::error;
+        scan_archive("archive, error and up", filter);
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t matched{grep_levels(text_path, LogLevel::error)};
+        print_query("text, error and up", seconds_since(start), matched,
+                    nullptr);
+    }
+    {
+        // The text file only has whole seconds, so it cannot answer this one
+        LogArchiveFilter filter{};
+        filter.from = first + (last - first) * 45 / 100;
+        filter.to = first + (last - first) * 55 / 100;
+        scan_archive("archive, middle 10% of time", filter);
+        filter.min_level = LogLevel::warning;
+        scan_archive("archive, middle 10%, warning and up", filter);
+    }
+
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(archive_path);
+}
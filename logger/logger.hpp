@@ -0,0 +1,176 @@
+/**
+ * @brief std::format based logger writing to a pair of streams
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+struct Logger {
+  enum class LogLevel { Info, Debug, Warning, Error, Critical, Disabled };
+
+  Logger(LogLevel level = LogLevel::Info, std::ostream& out_stream = std::cout,
+         std::ostream& err_stream = std::cerr)
+      : m_out_stream{out_stream}, m_err_stream{err_stream}, m_level{level} {}
+
+  template <typename... TFmtArgs>
+  void log_info(std::format_string<TFmtArgs...> fmt_str,
+                TFmtArgs&&... fmt_args) {
+    log<LogLevel::Info>(m_out_stream, fmt_str,
+                        std::forward<TFmtArgs>(fmt_args)...);
+  }
+  template <typename... TFmtArgs>
+  void log_warning(std::format_string<TFmtArgs...> fmt_str,
+                   TFmtArgs&&... fmt_args) {
+    log<LogLevel::Warning>(m_out_stream, fmt_str,
+                           std::forward<TFmtArgs>(fmt_args)...);
+  }
+  template <typename... TFmtArgs>
+  void log_error(std::format_string<TFmtArgs...> fmt_str,
+                 TFmtArgs&&... fmt_args) {
+    log<LogLevel::Error>(m_err_stream, fmt_str,
+                         std::forward<TFmtArgs>(fmt_args)...);
+  }
+  template <typename... TFmtArgs>
+  void log_debug(std::format_string<TFmtArgs...> fmt_str,
+                 TFmtArgs&&... fmt_args) {
+    log<LogLevel::Debug>(m_err_stream, fmt_str,
+                         std::forward<TFmtArgs>(fmt_args)...);
+  }
+  template <typename... TFmtArgs>
+  void log_critical(std::format_string<TFmtArgs...> fmt_str,
+                    TFmtArgs&&... fmt_args) {
+    log<LogLevel::Critical>(m_err_stream, fmt_str,
+                            std::forward<TFmtArgs>(fmt_args)...);
+  }
+
+  void flush() {
+    m_out_stream << std::flush;
+    m_err_stream << std::flush;
+  }
+
+private:
+  // Checks the level before formatting anything, then builds the whole
+  // line, prefix included, and hands it to the stream in one write. Lines
+  // that fit in kLineBuffer never touch the heap. std::format checks fmt_str
+  // at compile time but, unlike fmt's FMT_COMPILE, still parses it on every
+  // call.
+  template <LogLevel TLogLevel, typename... TFmtArgs>
+  void log(std::ostream& os, std::format_string<TFmtArgs...> fmt_str,
+           TFmtArgs&&... fmt_args) {
+    if (TLogLevel <= m_level) {
+      LineBuffer line{log_level_prefix<TLogLevel>()};
+      std::format_to(std::back_inserter(line), fmt_str,
+                     std::forward<TFmtArgs>(fmt_args)...);
+      line.push_back('\n');
+      const auto text = line.view();
+      os.write(text.data(), static_cast<std::streamsize>(text.size()));
+      os.flush();
+    }
+  }
+
+  static constexpr std::size_t kLineBuffer{256};
+
+  // One line being formatted: kept in place up to kLineBuffer bytes and
+  // moved to the heap by a line that outgrows them, so it is formatted once
+  // whatever its length
+  class LineBuffer {
+  public:
+    using value_type = char;
+
+    explicit LineBuffer(std::string_view prefix)
+        : m_end{std::copy(prefix.begin(), prefix.end(), m_fixed.begin())} {}
+
+    // m_end points into m_fixed
+    LineBuffer(const LineBuffer&) = delete;
+    LineBuffer& operator=(const LineBuffer&) = delete;
+
+    void push_back(char chr) {
+      if (m_end != m_fixed.end()) [[likely]] {
+        *m_end++ = chr;
+        return;
+      }
+      if (m_spill.empty()) {
+        m_spill.reserve(2 * m_fixed.size());
+        m_spill.assign(m_fixed.data(), m_fixed.size());
+      }
+      m_spill.push_back(chr);
+    }
+
+    [[nodiscard]] std::string_view view() const {
+      return m_spill.empty()
+                 ? std::string_view{m_fixed.data(),
+                                    static_cast<std::size_t>(
+                                        m_end - m_fixed.begin())}
+                 : std::string_view{m_spill};
+    }
+
+  private:
+    std::array<char, kLineBuffer> m_fixed;
+    std::array<char, kLineBuffer>::iterator m_end;
+    std::string m_spill;
+  };
+
+  // The level tag and the space after it
+  template <LogLevel TLogLevel>
+  static constexpr std::string_view log_level_prefix() {
+    static_assert(TLogLevel <= LogLevel::Disabled);
+    if constexpr (TLogLevel == LogLevel::Info) {
+      return "[Info] ";
+    }
+    if constexpr (TLogLevel == LogLevel::Debug) {
+      return "[Debug] ";
+    }
+    if constexpr (TLogLevel == LogLevel::Warning) {
+      return "[Warning] ";
+    }
+    if constexpr (TLogLevel == LogLevel::Error) {
+      return "[Error] ";
+    }
+    if constexpr (TLogLevel == LogLevel::Critical) {
+      return "[Critical] ";
+    }
+    if constexpr (TLogLevel == LogLevel::Disabled) {
+      return "[Disabled] ";
+    }
+  }
+
+  std::ostream& m_out_stream;
+  std::ostream& m_err_stream;
+
+  LogLevel m_level;
+};
+
+namespace global {
+inline Logger& get_logger(
+    std::optional<std::tuple<Logger::LogLevel, std::ostream&, std::ostream&>>
+        params = std::nullopt) {
+  static Logger logger = [](auto& inner_params) -> Logger {
+    if (inner_params.has_value()) {
+      return std::apply([](auto&... args) { return Logger(args...); },
+                        inner_params.value());
+      return Logger();
+    } else {
+      return Logger();
+    }
+  }(params);
+
+  return logger;
+}
+}  // namespace global
+
+#endif  // LOGGER_HPP
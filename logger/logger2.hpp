@@ -0,0 +1,428 @@
+/**
+ * @brief fmt based logger with pluggable sinks
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef LOGGER2_HPP
+#define LOGGER2_HPP
+
+#include <fmt/chrono.h>
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
+
+enum class LogLevel : std::uint8_t {
+    debug,     // 0
+    info,      // 1
+    warning,   // 2
+    error,     // 3
+    critical,  // 4
+    disabled   // 5
+};
+
+template <LogLevel Level>
+[[nodiscard]] constexpr std::string_view log_level_string() {
+    static_assert(Level < LogLevel::disabled);
+    if constexpr (Level == LogLevel::debug) {
+        return {"Debug"};
+    }
+    if constexpr (Level == LogLevel::info) {
+        return {"Info"};
+    }
+    if constexpr (Level == LogLevel::warning) {
+        return {"Warning"};
+    }
+    if constexpr (Level == LogLevel::error) {
+        return {"Error"};
+    }
+    if constexpr (Level == LogLevel::critical) {
+        return {"Critical"};
+    }
+}
+
+// A format string made with FMT_COMPILE("..."), which fmt turns into
+// formatting code at compile time instead of parsing it on every call.
+// fmt 11 exports the class FMT_COMPILE strings derive from; earlier versions
+// keep it in fmt::detail
+#if FMT_VERSION >= 110000
+template <typename S>
+concept CompiledFormat = std::is_base_of_v<fmt::compiled_string, S>;
+#else
+template <typename S>
+concept CompiledFormat = std::is_base_of_v<fmt::detail::compiled_string, S>;
+#endif
+
+/**
+ * Writes the part of a line that comes before the message,
+ * "datetime|level|file:function:line|", or "datetime|level||" without a
+ * source location.
+ *
+ * The layout is a compiled format, so nothing is parsed per call, and every
+ * field is a positional argument rather than a named one looked up at run
+ * time. The level name is a constant for each instantiation.
+ */
+struct DefaultFormatter {
+    template <LogLevel Level, typename OutputIt>
+    OutputIt format_prefix(OutputIt out,
+                           std::chrono::system_clock::time_point time,
+                           const std::source_location* src_loc) const {
+        if (src_loc != nullptr) {
+            return fmt::format_to(out,
+                                  FMT_COMPILE("{:%Y%m%d-%X}|{}|{}:{}:{}|"),
+                                  time, log_level_string<Level>(),
+                                  src_loc->file_name(),
+                                  src_loc->function_name(), src_loc->line());
+        }
+        return fmt::format_to(out, FMT_COMPILE("{:%Y%m%d-%X}|{}||"), time,
+                              log_level_string<Level>());
+    }
+};
+
+struct StdoutLogSink {
+    void log(std::string_view msg) { std::cout << msg << std::endl; }
+};
+
+template <typename MsgMask = decltype([](std::string_view msg) { return std::string(msg); })>
+struct FilteringStdoutLogSink {
+    void log(std::string_view msg) {
+        constexpr static auto mask = MsgMask{};
+        if (mask(msg) != mask(last_seen.first)) {
+            if (last_seen.second != 0) {
+                fmt::print(stdout, " ... repeated {} times\n", last_seen.second);
+            } else if (!last_seen.first.empty()) {
+                std::cout << std::endl;
+            }
+            last_seen.first = std::string(msg);
+            last_seen.second = 0;
+            std::cout << msg;
+        } else {
+            last_seen.second++;
+        }
+    }
+    ~FilteringStdoutLogSink() {
+        if (!last_seen.first.empty() && last_seen.second != 0) {
+            std::cout << fmt::format(" ... repeated {} times", last_seen.second) << std::endl;
+        }
+    }
+    std::pair<std::string, std::size_t> last_seen{};
+};
+
+// One logged line as the logger saw it. message and line view the same
+// buffer: line is the whole formatted line, message only the part after the
+// formatter's prefix. Both are valid for the duration of the sink call, and
+// line is empty when none of the logger's sinks takes text.
+struct LogRecord {
+    std::chrono::system_clock::time_point time;
+    LogLevel level;
+    const std::source_location* src_loc;
+    std::string_view message;
+    std::string_view line;
+};
+
+// A sink either has log(std::string_view) and is given the formatted line, or
+// log(const LogRecord&) and is given the fields the line was made from.
+//
+// The sink is copied or moved in. To have the logger use one that lives
+// elsewhere, pass std::ref(sink); that sink must then outlive every logger
+// holding it.
+struct LogSink {
+    struct LogSinkConcept {
+        virtual void log(const LogRecord& record) = 0;
+        [[nodiscard]] virtual bool wants_line() const = 0;
+    };
+
+    template <typename Concrete>
+    struct LogSinkModel : public LogSinkConcept {
+       private:
+        // The sink itself, or a std::reference_wrapper to it
+        Concrete m_sink;
+        using Sink = std::unwrap_reference_t<Concrete>;
+
+        Sink& sink() { return m_sink; }
+
+       public:
+        LogSinkModel(Concrete sink) : m_sink{std::move(sink)} {}
+
+        static constexpr bool kTakesRecords{
+            requires(Sink& sink, const LogRecord& record) {
+                sink.log(record);
+            }};
+
+        void log(const LogRecord& record) {
+            if constexpr (kTakesRecords) {
+                sink().log(record);
+            } else {
+                sink().log(record.line);
+            }
+        }
+        [[nodiscard]] bool wants_line() const { return !kTakesRecords; }
+        void add_filter() {}
+    };
+
+    template <typename Concrete>
+        requires(!std::same_as<std::remove_cvref_t<Concrete>, LogSink> &&
+                 std::constructible_from<std::remove_cvref_t<Concrete>,
+                                         Concrete>)
+    LogSink(Concrete&& sink)
+        : m_concept{
+              std::make_shared<LogSinkModel<std::remove_cvref_t<Concrete>>>(
+                  std::forward<Concrete>(sink))} {}
+
+    void log(const LogRecord& record) { m_concept->log(record); }
+    [[nodiscard]] bool wants_line() const { return m_concept->wants_line(); }
+
+   private:
+    std::shared_ptr<LogSinkConcept> m_concept{nullptr};
+};
+
+/**
+ * Every logging call takes either a checked fmt::format_string or an
+ * FMT_COMPILE("...") string; the second is formatted by code generated at
+ * compile time. Calls below the logger's level return before formatting.
+ */
+template <typename Formatter = DefaultFormatter, bool EnableSrcLocation = true>
+struct Logger {
+    struct LogCtx {
+        LogCtx(Logger& logger, std::source_location src_loc)
+            : m_logger{logger}, m_src_loc{src_loc} {}
+        template <typename... Args>
+        void debug(fmt::format_string<Args...> fmt_str, Args&&... args) {
+            m_logger.debug(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <CompiledFormat S, typename... Args>
+        void debug(const S& fmt_str, Args&&... args) {
+            m_logger.debug(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <typename... Args>
+        void info(fmt::format_string<Args...> fmt_str, Args&&... args) {
+            m_logger.info(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <CompiledFormat S, typename... Args>
+        void info(const S& fmt_str, Args&&... args) {
+            m_logger.info(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <typename... Args>
+        void warning(fmt::format_string<Args...> fmt_str, Args&&... args) {
+            m_logger.warning(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <CompiledFormat S, typename... Args>
+        void warning(const S& fmt_str, Args&&... args) {
+            m_logger.warning(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <typename... Args>
+        void error(fmt::format_string<Args...> fmt_str, Args&&... args) {
+            m_logger.error(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <CompiledFormat S, typename... Args>
+        void error(const S& fmt_str, Args&&... args) {
+            m_logger.error(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <typename... Args>
+        void critical(fmt::format_string<Args...> fmt_str, Args&&... args) {
+            m_logger.critical(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+        template <CompiledFormat S, typename... Args>
+        void critical(const S& fmt_str, Args&&... args) {
+            m_logger.critical(m_src_loc, fmt_str, std::forward<Args>(args)...);
+        }
+
+       private:
+        Logger& m_logger;
+        std::source_location m_src_loc;
+    };
+
+    template <typename... Args>
+    void debug(std::source_location src_loc,
+               fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::debug>(&src_loc, fmt_str, std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void debug(std::source_location src_loc, const S& fmt_str,
+               Args&&... args) {
+        log<LogLevel::debug>(&src_loc, fmt_str, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    void info(std::source_location src_loc, fmt::format_string<Args...> fmt_str,
+              Args&&... args) {
+        log<LogLevel::info>(&src_loc, fmt_str, std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void info(std::source_location src_loc, const S& fmt_str, Args&&... args) {
+        log<LogLevel::info>(&src_loc, fmt_str, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    void warning(std::source_location src_loc,
+                 fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::warning>(&src_loc, fmt_str,
+                               std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void warning(std::source_location src_loc, const S& fmt_str,
+                 Args&&... args) {
+        log<LogLevel::warning>(&src_loc, fmt_str,
+                               std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    void error(std::source_location src_loc,
+               fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::error>(&src_loc, fmt_str, std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void error(std::source_location src_loc, const S& fmt_str,
+               Args&&... args) {
+        log<LogLevel::error>(&src_loc, fmt_str, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    void critical(std::source_location src_loc,
+                  fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::critical>(&src_loc, fmt_str,
+                                std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void critical(std::source_location src_loc, const S& fmt_str,
+                  Args&&... args) {
+        log<LogLevel::critical>(&src_loc, fmt_str,
+                                std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void debug(fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::debug>(nullptr, fmt_str, std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void debug(const S& fmt_str, Args&&... args) {
+        log<LogLevel::debug>(nullptr, fmt_str, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    void info(fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::info>(nullptr, fmt_str, std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void info(const S& fmt_str, Args&&... args) {
+        log<LogLevel::info>(nullptr, fmt_str, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    void warning(fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::warning>(nullptr, fmt_str, std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void warning(const S& fmt_str, Args&&... args) {
+        log<LogLevel::warning>(nullptr, fmt_str, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    void error(fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::error>(nullptr, fmt_str, std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void error(const S& fmt_str, Args&&... args) {
+        log<LogLevel::error>(nullptr, fmt_str, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    void critical(fmt::format_string<Args...> fmt_str, Args&&... args) {
+        log<LogLevel::critical>(nullptr, fmt_str,
+                                std::forward<Args>(args)...);
+    }
+    template <CompiledFormat S, typename... Args>
+    void critical(const S& fmt_str, Args&&... args) {
+        log<LogLevel::critical>(nullptr, fmt_str,
+                                std::forward<Args>(args)...);
+    }
+
+    LogCtx with_ctx(
+        std::source_location src_loc = std::source_location::current()) {
+        return LogCtx{*this, src_loc};
+    }
+
+    void set_level(LogLevel level) { m_level = level; }
+
+    // Replaces any sink already registered under name
+    void add_sink(std::string name, LogSink sink) {
+        remove_sink(name);
+        m_sinks.emplace_back(std::move(name), std::move(sink));
+        update_wants_line();
+    }
+
+    void remove_sink(std::string_view name) {
+        std::erase_if(m_sinks,
+                      [name](const auto& entry) { return entry.first == name; });
+        update_wants_line();
+    }
+
+   private:
+    Formatter m_formatter;
+    LogLevel m_level{LogLevel::debug};
+    std::vector<std::pair<std::string, LogSink>> m_sinks{
+        {"default", FilteringStdoutLogSink<
+          decltype([](std::string_view msg) -> std::string {
+            if (msg.empty()) { return {""}; }
+            return std::string(msg.substr(msg.find('|')));
+          })
+        >{}}};
+    // False once every sink takes LogRecords, so the prefix is not formatted
+    bool m_wants_line{true};
+
+    void update_wants_line() {
+        m_wants_line = std::any_of(
+            m_sinks.begin(), m_sinks.end(),
+            [](const auto& entry) { return entry.second.wants_line(); });
+    }
+
+    template <LogLevel Level>
+    [[nodiscard]] bool should_log() const {
+        return m_level <= Level;
+    }
+
+    // Formats the whole line into one buffer, which only allocates for lines
+    // longer than fmt::memory_buffer's inline capacity
+    template <LogLevel Level, typename S, typename... Args>
+    void log(const std::source_location* src_loc, const S& fmt_str,
+             Args&&... args) {
+        if (!should_log<Level>()) {
+            return;
+        }
+        if constexpr (!EnableSrcLocation) {
+            src_loc = nullptr;
+        }
+
+        const auto time = std::chrono::system_clock::now();
+        fmt::memory_buffer line;
+        auto out = std::back_inserter(line);
+        if (m_wants_line) {
+            out = m_formatter.template format_prefix<Level>(out, time, src_loc);
+        }
+        const std::size_t prefix_size{line.size()};
+        fmt::format_to(out, fmt_str, std::forward<Args>(args)...);
+
+        const std::string_view text{line.data(), line.size()};
+        const LogRecord record{time, Level, src_loc, text.substr(prefix_size),
+                               m_wants_line ? text : std::string_view{}};
+        for (auto& sink : m_sinks) {
+            sink.second.log(record);
+        }
+    }
+};
+
+template <typename Formatter = DefaultFormatter, bool EnableSrcLocation = true>
+Logger<Formatter, EnableSrcLocation> & get_logger(/*std::optional<LoggerOpts> opts = std::nullopt*/) {
+    static Logger<Formatter, EnableSrcLocation> logger{/* opts.value_or(LoggerOpts{})*/};
+    return logger;
+}
+
+#endif  // LOGGER2_HPP
@@ -0,0 +1,147 @@
+#include <fmt/chrono.h>
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "logger2.hpp"
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+// GCC pairs the free below with the new-expression it was inlined into
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+#pragma GCC diagnostic pop
+
+namespace {
+
+// Keeps the optimizer from discarding the work being measured
+volatile std::uint64_t g_sink{0};
+
+struct Cost {
+  double ns;
+  double allocations;
+};
+
+template <typename TFunc>
+Cost per_call(std::size_t calls, TFunc&& func) {
+  const auto allocations = g_allocations.load(std::memory_order_relaxed);
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t call{0}; call < calls; ++call) {
+    func(call);
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  const auto allocated = g_allocations.load(std::memory_order_relaxed) -
+                         allocations;
+  return {std::chrono::duration<double, std::nano>(stop - start).count() /
+              static_cast<double>(calls),
+          static_cast<double>(allocated) / static_cast<double>(calls)};
+}
+
+void print(const char* label, Cost cost) {
+  std::cout << label << '\t' << cost.ns << '\t' << cost.allocations << '\n';
+}
+
+// Stands in for a real sink so the numbers are formatting alone
+struct NullSink {
+  void log(std::string_view msg) {
+    g_sink = g_sink + static_cast<std::uint64_t>(msg.size());
+  }
+};
+
+// How logger2 built a line before: each field formatted into its own string,
+// then all of them substituted by name into a runtime parsed layout
+template <bool WithSrcLoc, typename... Args>
+std::string named_layout(Args&&... args) {
+  if constexpr (WithSrcLoc) {
+    return fmt::format("{datetime}|{level}|{src_loc}|{msg}",
+                       std::forward<Args>(args)...);
+  } else {
+    return fmt::format("{datetime}|{level}||{msg}",
+                       std::forward<Args>(args)...);
+  }
+}
+
+template <typename... Args>
+std::string named_line(const std::source_location* src_loc,
+                       fmt::format_string<Args...> fmt_str, Args&&... args) {
+  const auto time = std::chrono::system_clock::now();
+  if (src_loc == nullptr) {
+    return named_layout<false>(
+        fmt::arg("datetime", fmt::format("{:%Y%m%d-%X}", time)),
+        fmt::arg("level", log_level_string<LogLevel::info>()),
+        fmt::arg("msg", fmt::format(fmt_str, std::forward<Args>(args)...)));
+  }
+  return named_layout<true>(
+      fmt::arg("datetime", fmt::format("{:%Y%m%d-%X}", time)),
+      fmt::arg("level", log_level_string<LogLevel::info>()),
+      fmt::arg("src_loc",
+               fmt::format("{}:{}:{}", src_loc->file_name(),
+                           src_loc->function_name(), src_loc->line())),
+      fmt::arg("msg", fmt::format(fmt_str, std::forward<Args>(args)...)));
+}
+
+void bench_logger2(std::size_t calls) {
+  Logger<> logger;
+  logger.remove_sink("default");
+  NullSink null_sink;
+  logger.add_sink("null", null_sink);
+  const auto src_loc = std::source_location::current();
+  const double value{3.25};
+
+  std::cout << "\tns per call\tallocations per call\n";
+  print("named layout", per_call(calls, [&](std::size_t call) {
+          null_sink.log(named_line(&src_loc, "request {} took {:.2f} ms",
+                                   call, value));
+        }));
+  print("compiled layout", per_call(calls, [&](std::size_t call) {
+          logger.info(src_loc, "request {} took {:.2f} ms", call, value);
+        }));
+  print("compiled layout + message", per_call(calls, [&](std::size_t call) {
+          logger.info(src_loc, FMT_COMPILE("request {} took {:.2f} ms"), call,
+                      value);
+        }));
+  print("named layout, no src_loc", per_call(calls, [&](std::size_t call) {
+          null_sink.log(
+              named_line(nullptr, "request {} took {:.2f} ms", call, value));
+        }));
+  print("compiled layout, no src_loc", per_call(calls, [&](std::size_t call) {
+          logger.info("request {} took {:.2f} ms", call, value);
+        }));
+  // Used to be formatted in full and then dropped
+  logger.set_level(LogLevel::error);
+  print("below level", per_call(calls, [&](std::size_t call) {
+          logger.info(src_loc, "request {} took {:.2f} ms", call, value);
+        }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t calls = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+  bench_logger2(calls);
+}
@@ -0,0 +1,97 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <new>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include "logger.hpp"
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+// GCC pairs the free below with the new-expression it was inlined into
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+#pragma GCC diagnostic pop
+
+namespace {
+
+// Keeps the optimizer from discarding the work being measured
+volatile std::uint64_t g_sink{0};
+
+struct Cost {
+  double ns;
+  double allocations;
+};
+
+template <typename TFunc>
+Cost per_call(std::size_t calls, TFunc&& func) {
+  const auto allocations = g_allocations.load(std::memory_order_relaxed);
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t call{0}; call < calls; ++call) {
+    func(call);
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  const auto allocated = g_allocations.load(std::memory_order_relaxed) -
+                         allocations;
+  return {std::chrono::duration<double, std::nano>(stop - start).count() /
+              static_cast<double>(calls),
+          static_cast<double>(allocated) / static_cast<double>(calls)};
+}
+
+void print(const char* label, Cost cost) {
+  std::cout << label << '\t' << cost.ns << '\t' << cost.allocations << '\n';
+}
+
+// Accepts and drops everything, so only formatting and stream calls remain
+struct NullBuffer : std::streambuf {
+  int overflow(int chr) override { return chr; }
+  std::streamsize xsputn(const char*, std::streamsize count) override {
+    g_sink = g_sink + static_cast<std::uint64_t>(count);
+    return count;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t calls = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+  NullBuffer buffer;
+  std::ostream null_stream{&buffer};
+  Logger logger{Logger::LogLevel::Warning, null_stream, null_stream};
+  const double value{3.25};
+
+  std::cout << "\tns per call\tallocations per call\n";
+  // How every log_* call wrote a line before
+  print("format, then stream", per_call(calls, [&](std::size_t call) {
+          null_stream << "[Info]" << " "
+                      << std::format("request {} took {:.2f} ms", call, value)
+                      << std::endl;
+        }));
+  print("one line, one write", per_call(calls, [&](std::size_t call) {
+          logger.log_info("request {} took {:.2f} ms", call, value);
+        }));
+  // Used to be formatted in full and then dropped
+  print("below level", per_call(calls, [&](std::size_t call) {
+          logger.log_critical("request {} took {:.2f} ms", call, value);
+        }));
+}
@@ -0,0 +1,284 @@
+/**
+ * @brief Values derived from Observables, recomputed lazily and glitch-free
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef COMPUTED_HPP
+#define COMPUTED_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "observable.hpp"
+
+/**
+ * @brief Type-independent part of a Computed: its place in the dependency graph
+ *
+ * A change to a source Observable marks its direct dependents Dirty and
+ * everything downstream of them Check; nothing is recomputed at that point.
+ * Reading a node brings it up to date by first updating its Check inputs, and
+ * only recomputes if one of them actually changed value. Nodes with
+ * subscribers are then updated eagerly in height order, so a subscriber never
+ * observes one input updated and another stale.
+ *
+ * The graph is per thread: a Computed and its inputs must be used from the
+ * thread that created them, and inputs must outlive (and not be moved out from
+ * under) their dependents.
+ */
+class ComputedNode {
+public:
+  ComputedNode(const ComputedNode&) = delete;
+  ComputedNode& operator=(const ComputedNode&) = delete;
+  ComputedNode(ComputedNode&&) = delete;
+  ComputedNode& operator=(ComputedNode&&) = delete;
+
+protected:
+  enum class State : std::uint8_t { Clean, Check, Dirty };
+
+  ComputedNode() = default;
+
+  virtual ~ComputedNode() {
+    for (auto& hub : m_hubs) {
+      std::erase(hub->dependents, this);
+    }
+    for (auto* input : m_inputs) {
+      std::erase(input->m_outputs, this);
+    }
+    for (auto* output : m_outputs) {
+      std::erase(output->m_inputs, this);
+    }
+    if (m_enqueued) {
+      auto& graph = Graph();
+      std::replace(graph.effects.begin(), graph.effects.end(),
+                   static_cast<ComputedNode*>(this),
+                   static_cast<ComputedNode*>(nullptr));
+      std::replace(graph.running.begin(), graph.running.end(),
+                   static_cast<ComputedNode*>(this),
+                   static_cast<ComputedNode*>(nullptr));
+    }
+  }
+
+  /**
+   * @brief Recompute the value from the inputs
+   * @return false if the new value compares equal to the old one
+   */
+  virtual bool Recompute() = 0;
+  [[nodiscard]] virtual bool Observed() const noexcept = 0;
+  // Deliver any notification Recompute held back during a flush
+  virtual void Publish() = 0;
+
+  template <typename TInput>
+  void DependOn(TInput& input) {
+    if constexpr (std::derived_from<TInput, ComputedNode>) {
+      ComputedNode& node = input;
+      m_inputs.push_back(&node);
+      node.m_outputs.push_back(this);
+      m_height = std::max(m_height, node.m_height + 1);
+    } else {
+      auto hub = HubFor(input);
+      hub->dependents.push_back(this);
+      m_hubs.push_back(std::move(hub));
+    }
+  }
+
+  void UpdateIfNecessary() {
+    if (m_state == State::Check) {
+      for (auto* input : m_inputs) {
+        input->UpdateIfNecessary();
+        if (m_state == State::Dirty) {
+          break;
+        }
+      }
+    }
+    if (m_state == State::Dirty && Recompute()) {
+      for (auto* output : m_outputs) {
+        output->Mark(State::Dirty);
+      }
+    }
+    m_state = State::Clean;
+  }
+
+  [[nodiscard]] static bool Flushing() noexcept { return Graph().flushing; }
+
+  State m_state{State::Clean};
+
+private:
+  // One subscription per source Observable, shared by all of its dependents, so
+  // that every dependent is marked before any of them is recomputed
+  struct SourceHub {
+    const void* source;
+    std::vector<ComputedNode*> dependents;
+    Subscription subscription;
+
+    ~SourceHub() { Graph().hubs.erase(source); }
+
+    void Changed() {
+      for (auto* dependent : dependents) {
+        dependent->Mark(State::Dirty);
+      }
+      if (!Flushing()) {
+        Flush();
+      }
+    }
+  };
+
+  struct GraphState {
+    std::unordered_map<const void*, std::weak_ptr<SourceHub>> hubs;
+    std::vector<ComputedNode*> effects;
+    std::vector<ComputedNode*> running;
+    bool flushing{false};
+  };
+
+  static GraphState& Graph() {
+    thread_local GraphState graph;
+    return graph;
+  }
+
+  template <typename TObservable>
+  static std::shared_ptr<SourceHub> HubFor(TObservable& source) {
+    auto& hubs = Graph().hubs;
+    if (auto it = hubs.find(&source); it != hubs.end()) {
+      if (auto hub = it->second.lock()) {
+        return hub;
+      }
+    }
+    auto hub = std::make_shared<SourceHub>(&source);
+    hub->subscription =
+        source.Subscribe([raw = hub.get()](const auto&) { raw->Changed(); });
+    hubs[&source] = hub;
+    return hub;
+  }
+
+  void Mark(State state) {
+    if (m_state >= state) {
+      return;
+    }
+    const bool was_clean = m_state == State::Clean;
+    m_state = state;
+    if (!m_enqueued && Observed()) {
+      m_enqueued = true;
+      Graph().effects.push_back(this);
+    }
+    if (was_clean) {
+      for (auto* output : m_outputs) {
+        output->Mark(State::Check);
+      }
+    }
+  }
+
+  static void Flush() {
+    auto& graph = Graph();
+    struct FlushGuard {
+      GraphState& graph;
+      ~FlushGuard() {
+        graph.flushing = false;
+        graph.running.clear();
+      }
+    };
+
+    graph.flushing = true;
+    FlushGuard guard{graph};
+    // Subscribers may write to sources, which enqueues another round
+    while (!graph.effects.empty()) {
+      graph.running.swap(graph.effects);
+      std::sort(graph.running.begin(), graph.running.end(),
+                [](const ComputedNode* lhs, const ComputedNode* rhs) {
+                  return lhs->m_height < rhs->m_height;
+                });
+      for (std::size_t idx{0}; idx < graph.running.size(); ++idx) {
+        if (auto* node = graph.running[idx]) {
+          node->m_enqueued = false;
+          node->UpdateIfNecessary();
+          node->Publish();
+        }
+      }
+      graph.running.clear();
+    }
+  }
+
+  std::vector<ComputedNode*> m_inputs;
+  std::vector<ComputedNode*> m_outputs;
+  std::vector<std::shared_ptr<SourceHub>> m_hubs;
+  std::uint32_t m_height{1};
+  bool m_enqueued{false};
+};
+
+/**
+ * @brief Observable value computed from other Observables or Computeds
+ *
+ * The function is called with the current values of the inputs, in order. The
+ * result is cached and only recomputed when read after an input changed; if it
+ * compares equal to the previous result, propagation stops there.
+ */
+template <typename TValueType>
+class Computed final : public ComputedNode {
+public:
+  template <typename TFunc, typename... TInputs>
+  explicit Computed(TFunc&& func, TInputs&... inputs)
+    requires std::convertible_to<
+                 std::invoke_result_t<std::decay_t<TFunc>&,
+                                      decltype(inputs.Value())...>,
+                 TValueType>
+      : m_func{[func = std::forward<TFunc>(func), &inputs...]() mutable {
+          return static_cast<TValueType>(func(inputs.Value()...));
+        }},
+        m_output{m_func()} {
+    (DependOn(inputs), ...);
+  }
+
+  [[nodiscard]] const TValueType& Value() {
+    UpdateIfNecessary();
+    return m_output.Value();
+  }
+
+  template <typename TFunc>
+  [[nodiscard]] Subscription Subscribe(TFunc&& func)
+    requires std::is_invocable_v<std::decay_t<TFunc>&, const TValueType&>
+  {
+    return m_output.Subscribe(std::forward<TFunc>(func));
+  }
+
+  [[nodiscard]] std::size_t SubscriberCount() const noexcept {
+    return m_output.SubscriberCount();
+  }
+
+private:
+  using Output = Observable<TValueType>;
+
+  bool Recompute() override {
+    auto next = m_func();
+    if constexpr (std::equality_comparable<TValueType>) {
+      if (next == m_output.Value()) {
+        return false;
+      }
+    }
+    // During a flush, hold the notification until Publish so subscribers run
+    // in height order; otherwise the assignment notifies straight away
+    if (!m_deferred && Flushing() && Observed()) {
+      m_deferred.emplace(m_output);
+    }
+    m_output = std::move(next);
+    return true;
+  }
+
+  [[nodiscard]] bool Observed() const noexcept override {
+    return m_output.SubscriberCount() > 0;
+  }
+
+  void Publish() override { m_deferred.reset(); }
+
+  std::function<TValueType()> m_func;
+  Output m_output;
+  std::optional<typename Output::Transaction> m_deferred;
+};
+
+#endif  // COMPUTED_HPP
@@ -0,0 +1,788 @@
+/**
+ * @brief Observable value that notifies subscribers on change
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef OBSERVABLE_HPP
+#define OBSERVABLE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Move-only type-erased callable that never allocates
+ *
+ * The callable is stored inline in NCapacity bytes; anything that does not fit
+ * is rejected at compile time instead of silently falling back to the heap.
+ */
+template <typename TSignature, std::size_t NCapacity = 64,
+          std::size_t NAlign = alignof(std::max_align_t)>
+class InplaceFunction;
+
+template <typename TReturnType, typename... TArgs, std::size_t NCapacity,
+          std::size_t NAlign>
+class InplaceFunction<TReturnType(TArgs...), NCapacity, NAlign> {
+public:
+  template <typename TFunc>
+  InplaceFunction(TFunc&& func)
+    requires(!std::same_as<std::remove_cvref_t<TFunc>, InplaceFunction> &&
+             std::is_invocable_r_v<TReturnType, std::decay_t<TFunc>&,
+                                   TArgs...>)
+  {
+    using TStored = std::decay_t<TFunc>;
+    static_assert(sizeof(TStored) <= NCapacity,
+                  "Callable does not fit in InplaceFunction storage");
+    static_assert(NAlign % alignof(TStored) == 0,
+                  "Callable is over-aligned for InplaceFunction storage");
+    static_assert(std::is_nothrow_move_constructible_v<TStored>,
+                  "Callable must be nothrow move constructible");
+    ::new (static_cast<void*>(m_storage)) TStored(std::forward<TFunc>(func));
+    m_ops = &ops_for<TStored>;
+  }
+
+  InplaceFunction(const InplaceFunction&) = delete;
+  InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+  InplaceFunction(InplaceFunction&& other) noexcept : m_ops{other.m_ops} {
+    if (m_ops != nullptr) {
+      m_ops->move(m_storage, other.m_storage);
+      other.m_ops = nullptr;
+    }
+  }
+
+  InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+    if (&other != this) {
+      reset();
+      m_ops = other.m_ops;
+      if (m_ops != nullptr) {
+        m_ops->move(m_storage, other.m_storage);
+        other.m_ops = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  ~InplaceFunction() { reset(); }
+
+  TReturnType operator()(TArgs... args) const {
+    return m_ops->invoke(m_storage, std::forward<TArgs>(args)...);
+  }
+
+  explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+private:
+  struct Ops {
+    TReturnType (*invoke)(void*, TArgs&&...);
+    // Move constructs into dst and destroys src
+    void (*move)(void* dst, void* src) noexcept;
+    void (*destroy)(void*) noexcept;
+  };
+
+  template <typename TStored>
+  static constexpr Ops ops_for{
+      [](void* self, TArgs&&... args) -> TReturnType {
+        return std::invoke(*static_cast<TStored*>(self),
+                           std::forward<TArgs>(args)...);
+      },
+      [](void* dst, void* src) noexcept {
+        ::new (dst) TStored(std::move(*static_cast<TStored*>(src)));
+        static_cast<TStored*>(src)->~TStored();
+      },
+      [](void* self) noexcept { static_cast<TStored*>(self)->~TStored(); }};
+
+  void reset() noexcept {
+    if (m_ops != nullptr) {
+      m_ops->destroy(m_storage);
+      m_ops = nullptr;
+    }
+  }
+
+  alignas(NAlign) mutable std::byte m_storage[NCapacity];
+  const Ops* m_ops{nullptr};
+};
+
+/**
+ * @brief Per-subscriber callback timings
+ *
+ * Only collected when built with OBSERVABLE_ENABLE_STATS; otherwise every
+ * field stays zero and no clock is read.
+ */
+struct SubscriberStats {
+  std::uint64_t calls{0};
+  std::uint64_t total_ns{0};
+  std::uint64_t max_ns{0};
+};
+
+/**
+ * @brief Per-Observable counters, collected under OBSERVABLE_ENABLE_STATS
+ */
+struct ObservableStats {
+  // Notify calls that went out to subscribers
+  std::uint64_t notifications{0};
+  // Update calls whose updater reported no change
+  std::uint64_t suppressed_updates{0};
+  // Changes folded into a pending transaction instead of notifying
+  std::uint64_t coalesced_changes{0};
+};
+
+/**
+ * @brief Stable name for a subscriber; goes stale once it is unsubscribed
+ */
+struct SubscriptionKey {
+  std::uint32_t index{0};
+  std::uint32_t generation{0};
+};
+
+struct SubscriptionOwner {
+  virtual bool Unsubscribe(SubscriptionKey key) noexcept = 0;
+
+protected:
+  ~SubscriptionOwner() = default;
+};
+
+/**
+ * @brief RAII handle returned by Observable::Subscribe
+ *
+ * Unsubscribes on destruction. Holds only a weak reference to the subscriber
+ * storage, so it is safe to outlive (or be moved away from) its Observable.
+ */
+class Subscription {
+public:
+  Subscription() = default;
+  Subscription(std::weak_ptr<SubscriptionOwner> owner, SubscriptionKey key)
+      : m_owner{std::move(owner)}, m_key{key} {}
+
+  Subscription(const Subscription&) = delete;
+  Subscription& operator=(const Subscription&) = delete;
+
+  Subscription(Subscription&& other) noexcept
+      : m_owner{std::move(other.m_owner)}, m_key{other.m_key} {}
+
+  Subscription& operator=(Subscription&& other) noexcept {
+    if (&other != this) {
+      Unsubscribe();
+      m_owner = std::move(other.m_owner);
+      m_key = other.m_key;
+    }
+    return *this;
+  }
+
+  ~Subscription() { Unsubscribe(); }
+
+  /**
+   * @brief Remove the subscriber now
+   * @return false if it was already gone or the Observable no longer exists
+   */
+  bool Unsubscribe() noexcept {
+    if (auto owner = m_owner.lock()) {
+      m_owner.reset();
+      return owner->Unsubscribe(m_key);
+    }
+    return false;
+  }
+
+  /**
+   * @brief Detach the handle, leaving the subscriber registered for good
+   */
+  SubscriptionKey Release() noexcept {
+    m_owner.reset();
+    return m_key;
+  }
+
+  [[nodiscard]] SubscriptionKey Key() const noexcept { return m_key; }
+
+private:
+  std::weak_ptr<SubscriptionOwner> m_owner;
+  SubscriptionKey m_key;
+};
+
+/**
+ * @brief Generational slot map of subscriber callbacks
+ *
+ * Callbacks live in a dense vector that Invoke walks front to back; the sparse
+ * slot array maps keys to dense positions so unsubscribing is an O(1)
+ * swap-and-pop. Inserts and erases issued while Invoke is running (including
+ * from inside a callback) are deferred until the outermost Invoke returns, so
+ * the callback currently executing is never moved or destroyed under itself.
+ *
+ * Single threaded by default. Once SetSynchronized(true) is called every
+ * operation takes a recursive mutex, which is what lets an executor deliver
+ * notifications on a worker thread while the owner keeps subscribing.
+ */
+template <typename TCallback>
+class SubscriberSlotMap final : public SubscriptionOwner {
+public:
+  template <typename TFunc>
+  SubscriptionKey Insert(TFunc&& func) {
+    const auto lock = MaybeLock();
+    const auto slot_idx = AcquireSlot();
+    auto& slot = m_slots[slot_idx];
+    if (m_depth == 0) {
+      slot.dense_or_next_free = static_cast<std::uint32_t>(m_callbacks.size());
+      m_callbacks.emplace_back(std::forward<TFunc>(func));
+      m_dense_to_slot.push_back(slot_idx);
+#ifdef OBSERVABLE_ENABLE_STATS
+      m_stats.emplace_back();
+#endif
+    } else {
+      slot.dense_or_next_free =
+          static_cast<std::uint32_t>(m_callbacks.size() + m_pending.size());
+      m_pending.emplace_back(std::forward<TFunc>(func));
+      m_pending_to_slot.push_back(slot_idx);
+    }
+    return {slot_idx, slot.generation};
+  }
+
+  bool Unsubscribe(SubscriptionKey key) noexcept override {
+    const auto lock = MaybeLock();
+    if (!ContainsUnlocked(key)) {
+      return false;
+    }
+    const auto dense_idx = m_slots[key.index].dense_or_next_free;
+    ReleaseSlot(key.index);
+    if (m_depth == 0) {
+      EraseDense(dense_idx);
+    } else {
+      if (dense_idx < m_callbacks.size()) {
+        m_dense_to_slot[dense_idx] = kNoIndex;
+      } else {
+        m_pending_to_slot[dense_idx - m_callbacks.size()] = kNoIndex;
+      }
+      m_erased.push_back(dense_idx);
+    }
+    return true;
+  }
+
+  [[nodiscard]] bool Contains(SubscriptionKey key) const noexcept {
+    const auto lock = MaybeLock();
+    return ContainsUnlocked(key);
+  }
+
+  [[nodiscard]] std::size_t Size() const noexcept {
+    const auto lock = MaybeLock();
+    return m_callbacks.size() + m_pending.size() - m_erased.size();
+  }
+
+  /**
+   * @brief Guard every operation with a mutex from now on
+   *
+   * Must be called before the slot map is shared with another thread.
+   */
+  void SetSynchronized(bool synchronized) noexcept {
+    m_synchronized = synchronized;
+  }
+
+  template <typename... TArgs>
+  void Invoke(const TArgs&... args) {
+    struct DepthGuard {
+      SubscriberSlotMap& self;
+      ~DepthGuard() {
+        if (--self.m_depth == 0) {
+          self.Flush();
+        }
+      }
+    };
+
+    const auto lock = MaybeLock();
+    ++m_depth;
+    DepthGuard guard{*this};
+    // Subscribers added during this pass land in m_pending and are not called
+    const auto count = m_callbacks.size();
+    for (std::size_t idx{0}; idx < count; ++idx) {
+      if (m_dense_to_slot[idx] != kNoIndex) {
+#ifdef OBSERVABLE_ENABLE_STATS
+        const auto start = std::chrono::steady_clock::now();
+        m_callbacks[idx](args...);
+        const auto elapsed = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+        auto& stats = m_stats[idx];
+        ++stats.calls;
+        stats.total_ns += elapsed;
+        stats.max_ns = std::max(stats.max_ns, elapsed);
+#else
+        m_callbacks[idx](args...);
+#endif
+      }
+    }
+  }
+
+  [[nodiscard]] SubscriberStats StatsFor(SubscriptionKey key) const {
+    const auto lock = MaybeLock();
+#ifdef OBSERVABLE_ENABLE_STATS
+    if (ContainsUnlocked(key)) {
+      const auto dense_idx = m_slots[key.index].dense_or_next_free;
+      if (dense_idx < m_stats.size()) {
+        return m_stats[dense_idx];
+      }
+    }
+#endif
+    return {};
+  }
+
+  /**
+   * @brief Visit every live subscriber's key and stats, e.g. to find slow ones
+   */
+  template <typename TFunc>
+  void ForEachStats(TFunc&& func) const {
+    const auto lock = MaybeLock();
+#ifdef OBSERVABLE_ENABLE_STATS
+    for (std::size_t idx{0}; idx < m_stats.size(); ++idx) {
+      if (const auto slot_idx = m_dense_to_slot[idx]; slot_idx != kNoIndex) {
+        func(SubscriptionKey{slot_idx, m_slots[slot_idx].generation},
+             m_stats[idx]);
+      }
+    }
+#endif
+  }
+
+private:
+  static constexpr std::uint32_t kNoIndex =
+      std::numeric_limits<std::uint32_t>::max();
+
+  struct Slot {
+    // Dense index while live, next free slot while on the free list
+    std::uint32_t dense_or_next_free;
+    std::uint32_t generation;
+    bool live;
+  };
+
+  [[nodiscard]] std::unique_lock<std::recursive_mutex> MaybeLock() const {
+    if (m_synchronized) {
+      return std::unique_lock{m_mutex};
+    }
+    return {};
+  }
+
+  [[nodiscard]] bool ContainsUnlocked(SubscriptionKey key) const noexcept {
+    return key.index < m_slots.size() &&
+           m_slots[key.index].generation == key.generation &&
+           m_slots[key.index].live;
+  }
+
+  std::uint32_t AcquireSlot() {
+    if (m_free_head != kNoIndex) {
+      const auto slot_idx = m_free_head;
+      m_free_head = m_slots[slot_idx].dense_or_next_free;
+      m_slots[slot_idx].live = true;
+      return slot_idx;
+    }
+    m_slots.push_back({kNoIndex, 0, true});
+    return static_cast<std::uint32_t>(m_slots.size() - 1);
+  }
+
+  void ReleaseSlot(std::uint32_t slot_idx) noexcept {
+    auto& slot = m_slots[slot_idx];
+    ++slot.generation;
+    slot.live = false;
+    slot.dense_or_next_free = m_free_head;
+    m_free_head = slot_idx;
+  }
+
+  void EraseDense(std::uint32_t dense_idx) noexcept {
+    const auto last = static_cast<std::uint32_t>(m_callbacks.size() - 1);
+    if (dense_idx != last) {
+      m_callbacks[dense_idx] = std::move(m_callbacks[last]);
+      m_dense_to_slot[dense_idx] = m_dense_to_slot[last];
+#ifdef OBSERVABLE_ENABLE_STATS
+      m_stats[dense_idx] = m_stats[last];
+#endif
+      if (m_dense_to_slot[dense_idx] != kNoIndex) {
+        m_slots[m_dense_to_slot[dense_idx]].dense_or_next_free = dense_idx;
+      }
+    }
+    m_callbacks.pop_back();
+    m_dense_to_slot.pop_back();
+#ifdef OBSERVABLE_ENABLE_STATS
+    m_stats.pop_back();
+#endif
+  }
+
+  void Flush() {
+    for (std::size_t idx{0}; idx < m_pending.size(); ++idx) {
+      m_callbacks.push_back(std::move(m_pending[idx]));
+      m_dense_to_slot.push_back(m_pending_to_slot[idx]);
+#ifdef OBSERVABLE_ENABLE_STATS
+      m_stats.emplace_back();
+#endif
+    }
+    m_pending.clear();
+    m_pending_to_slot.clear();
+
+    // Highest first, so the element swapped down from the back is always live
+    std::sort(m_erased.begin(), m_erased.end(), std::greater<>{});
+    for (const auto dense_idx : m_erased) {
+      EraseDense(dense_idx);
+    }
+    m_erased.clear();
+  }
+
+  std::vector<TCallback> m_callbacks;
+  std::vector<std::uint32_t> m_dense_to_slot;
+#ifdef OBSERVABLE_ENABLE_STATS
+  // Parallel to m_callbacks, kept out of line so Invoke stays dense without it
+  std::vector<SubscriberStats> m_stats;
+#endif
+  std::vector<Slot> m_slots;
+  std::uint32_t m_free_head{kNoIndex};
+
+  std::vector<TCallback> m_pending;
+  std::vector<std::uint32_t> m_pending_to_slot;
+  std::vector<std::uint32_t> m_erased;
+  std::uint32_t m_depth{0};
+
+  mutable std::recursive_mutex m_mutex;
+  bool m_synchronized{false};
+};
+
+/**
+ * @brief Where asynchronous notifications are run
+ */
+struct Executor {
+  using Task = InplaceFunction<void()>;
+
+  virtual ~Executor() = default;
+  virtual void Post(Task task) = 0;
+};
+
+/**
+ * @brief Executor whose workers drain the whole task queue per wake-up
+ *
+ * Posting only appends under a lock and signals, so the posting thread never
+ * waits on a running task. Remaining tasks are run before destruction returns.
+ */
+class BatchExecutor final : public Executor {
+public:
+  explicit BatchExecutor(std::size_t num_workers = 1) {
+    m_workers.reserve(num_workers);
+    for (std::size_t idx{0}; idx < num_workers; ++idx) {
+      m_workers.emplace_back([this] { Run(); });
+    }
+  }
+
+  BatchExecutor(const BatchExecutor&) = delete;
+  BatchExecutor& operator=(const BatchExecutor&) = delete;
+
+  ~BatchExecutor() override {
+    {
+      std::lock_guard lock{m_mutex};
+      m_stopping = true;
+    }
+    m_cv.notify_all();
+    for (auto& worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  void Post(Task task) override {
+    {
+      std::lock_guard lock{m_mutex};
+      m_queue.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+  }
+
+private:
+  void Run() {
+    std::vector<Task> batch;
+    for (;;) {
+      {
+        std::unique_lock lock{m_mutex};
+        m_cv.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if (m_queue.empty()) {
+          return;
+        }
+        batch.swap(m_queue);
+      }
+      for (auto& task : batch) {
+        task();
+      }
+      batch.clear();
+    }
+  }
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<Task> m_queue;
+  bool m_stopping{false};
+  std::vector<std::thread> m_workers;
+};
+
+/**
+ * @brief Default Observable updater: store the new value and always notify
+ *
+ * A named type rather than a lambda in the default template argument, which
+ * GCC re-mints per mention inside other templates and then fails to match.
+ */
+template <typename TValueType>
+struct AssignUpdater {
+  constexpr bool operator()(const TValueType& new_val,
+                            TValueType& held) const {
+    held = new_val;
+    return true;
+  }
+
+  constexpr bool operator()(TValueType&& new_val, TValueType& held) const {
+    held = std::move(new_val);
+    return true;
+  }
+};
+
+template <typename TValueType, typename TUpdater = AssignUpdater<TValueType>,
+          bool = std::is_default_constructible_v<TValueType>,
+          bool = std::is_move_constructible_v<TValueType>,
+          bool = std::is_copy_constructible_v<TValueType>,
+          bool = std::is_copy_assignable_v<TValueType>,
+          bool = std::is_move_assignable_v<TValueType>>
+struct Observable {
+  // Subscribers see the held value by const reference, so a notification costs
+  // no copies regardless of payload size or subscriber count
+  using Callback = InplaceFunction<void(const TValueType&)>;
+
+  Observable() noexcept(std::is_nothrow_default_constructible_v<TValueType>)
+      : m_value{} {}
+
+  Observable(const Observable&) = delete;
+  Observable& operator=(const Observable&) = delete;
+
+  Observable(Observable&&) noexcept(
+      std::is_nothrow_move_constructible_v<TValueType>) = default;
+  Observable& operator=(Observable&&) noexcept(
+      std::is_nothrow_move_assignable_v<TValueType>) = default;
+
+  Observable(const TValueType& value) : m_value{value} {}
+  Observable(TValueType&& value) : m_value{std::move(value)} {}
+
+  /**
+   * @brief Defers notification until the outermost transaction ends
+   *
+   * Any number of assignments and successful updates made while a transaction
+   * is open result in a single Notify with the final value at commit.
+   */
+  class Transaction {
+  public:
+    explicit Transaction(Observable& obs) noexcept : m_obs{&obs} {
+      ++obs.m_tx_depth;
+    }
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    Transaction(Transaction&& other) noexcept
+        : m_obs{std::exchange(other.m_obs, nullptr)} {}
+    Transaction& operator=(Transaction&&) = delete;
+
+    ~Transaction() { Commit(); }
+
+    void Commit() {
+      if (auto* obs = std::exchange(m_obs, nullptr);
+          obs != nullptr && --obs->m_tx_depth == 0 && obs->m_tx_dirty) {
+        obs->m_tx_dirty = false;
+        obs->Notify(obs->m_value);
+      }
+    }
+
+  private:
+    Observable* m_obs;
+  };
+
+  Observable& operator=(const TValueType& value) {
+    m_value = value;
+    Changed();
+    return *this;
+  }
+
+  Observable& operator=(TValueType&& value) {
+    m_value = std::move(value);
+    Changed();
+    return *this;
+  }
+
+  void Update(const TValueType& val) {
+    static constexpr auto updater = TUpdater{};
+    if (updater(val, m_value)) {
+      Changed();
+    } else {
+      CountSuppressed();
+    }
+  }
+
+  void Update(TValueType&& val) {
+    static constexpr auto updater = TUpdater{};
+    if (updater(std::forward<TValueType>(val), m_value)) {
+      Changed();
+    } else {
+      CountSuppressed();
+    }
+  }
+
+  [[nodiscard]] const TValueType& Value() const noexcept { return m_value; }
+
+  void Notify(const TValueType& last) const {
+    if (!m_subs) {
+      return;
+    }
+#ifdef OBSERVABLE_ENABLE_STATS
+    ++m_stats.notifications;
+#endif
+    if (m_async) {
+      NotifyAsync(last);
+    } else {
+      m_subs->Invoke(last);
+    }
+  }
+
+  [[nodiscard]] Transaction BeginTransaction() noexcept {
+    return Transaction{*this};
+  }
+
+  /**
+   * @brief Deliver notifications on an executor instead of the caller
+   *
+   * Each notification snapshots the value into a shared immutable copy.
+   * Delivery is serial and in order; snapshots that pile up behind a slow
+   * subscriber are coalesced so only the latest one is delivered. Passing
+   * nullptr returns to synchronous delivery.
+   */
+  void DispatchOn(std::shared_ptr<Executor> executor) {
+    if (executor) {
+      Subscribers().SetSynchronized(true);
+      m_async = std::make_shared<AsyncDispatch>();
+    } else {
+      m_async.reset();
+    }
+    m_executor = std::move(executor);
+  }
+
+  template <typename TFunc>
+  [[nodiscard]] Subscription Subscribe(TFunc&& func)
+    requires std::is_invocable_v<std::decay_t<TFunc>&, const TValueType&>
+  {
+    const auto key = Subscribers().Insert(std::forward<TFunc>(func));
+    return {std::weak_ptr<SubscriptionOwner>{m_subs}, key};
+  }
+
+  /**
+   * @brief Remove a subscriber by key; safe to call from inside a callback
+   * @return false if the key is stale
+   */
+  bool Unsubscribe(SubscriptionKey key) noexcept {
+    return m_subs && m_subs->Unsubscribe(key);
+  }
+
+  [[nodiscard]] std::size_t SubscriberCount() const noexcept {
+    return m_subs ? m_subs->Size() : 0;
+  }
+
+  /**
+   * @brief Counters for this Observable; all zero unless built with
+   * OBSERVABLE_ENABLE_STATS
+   */
+  [[nodiscard]] ObservableStats Stats() const noexcept {
+#ifdef OBSERVABLE_ENABLE_STATS
+    return m_stats;
+#else
+    return {};
+#endif
+  }
+
+  [[nodiscard]] SubscriberStats StatsFor(SubscriptionKey key) const {
+    return m_subs ? m_subs->StatsFor(key) : SubscriberStats{};
+  }
+
+  template <typename TFunc>
+  void ForEachSubscriberStats(TFunc&& func) const {
+    if (m_subs) {
+      m_subs->ForEachStats(std::forward<TFunc>(func));
+    }
+  }
+
+private:
+  // Deliberately does not own the executor: tasks keep this alive, and an
+  // executor must never be destroyed from one of its own workers
+  struct AsyncDispatch {
+    std::mutex mutex;
+    std::shared_ptr<const TValueType> latest;
+    bool scheduled{false};
+  };
+
+  void Changed() {
+    if (m_tx_depth > 0) {
+#ifdef OBSERVABLE_ENABLE_STATS
+      ++m_stats.coalesced_changes;
+#endif
+      m_tx_dirty = true;
+    } else {
+      Notify(m_value);
+    }
+  }
+
+  // A moved-from Observable has no slot map; subscribing to it again starts
+  // a fresh one, as assigning it a value starts a fresh value
+  SubscriberSlotMap<Callback>& Subscribers() {
+    if (!m_subs) {
+      m_subs = std::make_shared<SubscriberSlotMap<Callback>>();
+    }
+    return *m_subs;
+  }
+
+  void CountSuppressed() noexcept {
+#ifdef OBSERVABLE_ENABLE_STATS
+    ++m_stats.suppressed_updates;
+#endif
+  }
+
+  void NotifyAsync(const TValueType& last) const {
+    auto snapshot = std::make_shared<const TValueType>(last);
+    {
+      std::lock_guard lock{m_async->mutex};
+      m_async->latest = std::move(snapshot);
+      if (std::exchange(m_async->scheduled, true)) {
+        return;
+      }
+    }
+    m_executor->Post([async = m_async, subs = m_subs] {
+      for (;;) {
+        std::shared_ptr<const TValueType> batch;
+        {
+          std::lock_guard lock{async->mutex};
+          if (!async->latest) {
+            async->scheduled = false;
+            return;
+          }
+          batch = std::move(async->latest);
+        }
+        subs->Invoke(*batch);
+      }
+    });
+  }
+
+  // Shared so that Subscription handles survive the Observable being moved
+  std::shared_ptr<SubscriberSlotMap<Callback>> m_subs{
+      std::make_shared<SubscriberSlotMap<Callback>>()};
+  std::shared_ptr<Executor> m_executor;
+  std::shared_ptr<AsyncDispatch> m_async;
+  std::uint32_t m_tx_depth{0};
+  bool m_tx_dirty{false};
+#ifdef OBSERVABLE_ENABLE_STATS
+  mutable ObservableStats m_stats;
+#endif
+  TValueType m_value;
+};
+
+#endif  // OBSERVABLE_HPP
@@ -0,0 +1,805 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "computed.hpp"
+#include "observable.hpp"
+#include "observable_containers.hpp"
+#include "read_mostly_observable.hpp"
+#include "shared_observable.hpp"
+
+namespace {
+
+struct Payload {
+  std::array<std::uint8_t, 1024> bytes{};
+
+  bool operator==(const Payload&) const = default;
+};
+
+// Keeps the optimizer from discarding subscriber work
+volatile std::uint64_t g_sink{0};
+
+// Mirror of the original by-value Notify over std::function subscribers, kept
+// here only as the baseline to compare against
+template <typename TValueType>
+struct ByValueObservable {
+  ByValueObservable& operator=(const TValueType& value) {
+    m_value = value;
+    Notify(m_value);
+    return *this;
+  }
+
+  void Notify(TValueType last) const {
+    for (const auto& sub : m_subs) {
+      sub(last);
+    }
+  }
+
+  void Subscribe(std::function<void(TValueType)>&& func) {
+    m_subs.push_back(std::move(func));
+  }
+
+private:
+  std::vector<std::function<void(TValueType)>> m_subs;
+  TValueType m_value;
+};
+
+template <typename TFunc>
+double time_ns_per_iter(std::size_t iters, TFunc&& func) {
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i{0}; i < iters; ++i) {
+    func(i);
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() /
+         static_cast<double>(iters);
+}
+
+void bench_notify_fan_out() {
+  std::cout << "notify fan-out, 1 KiB payload (ns per update)\n";
+  std::cout << "subscribers\tby-value\tby-ref\n";
+  for (const std::size_t num_subs : {1u, 10u, 100u, 1000u, 10000u}) {
+    const std::size_t iters = 1'000'000 / num_subs + 10;
+
+    ByValueObservable<Payload> legacy;
+    Observable<Payload> current;
+    std::vector<Subscription> subs;
+    for (std::size_t s{0}; s < num_subs; ++s) {
+      legacy.Subscribe([s](Payload p) { g_sink = g_sink + p.bytes[s % 1024]; });
+      subs.push_back(current.Subscribe(
+          [s](const Payload& p) { g_sink = g_sink + p.bytes[s % 1024]; }));
+    }
+
+    Payload payload{};
+    const auto legacy_ns = time_ns_per_iter(iters, [&](std::size_t i) {
+      payload.bytes[0] = static_cast<std::uint8_t>(i);
+      legacy = payload;
+    });
+    const auto current_ns = time_ns_per_iter(iters, [&](std::size_t i) {
+      payload.bytes[0] = static_cast<std::uint8_t>(i);
+      current = payload;
+    });
+    std::cout << num_subs << '\t' << legacy_ns << '\t' << current_ns << '\n';
+  }
+}
+
+template <std::size_t NBytes>
+struct Blob {
+  std::array<std::uint8_t, NBytes> bytes{};
+
+  bool operator==(const Blob&) const = default;
+};
+
+// Suppresses writes of an equal value, trading a compare for the fan-out
+template <typename TValueType>
+struct CompareUpdater {
+  bool operator()(const TValueType& val, TValueType& out) const {
+    if (val == out) {
+      return false;
+    }
+    out = val;
+    return true;
+  }
+};
+
+void bench_notify_latency() {
+  std::cout << "single notify latency vs subscribers, int payload\n";
+  std::cout << "subscribers\tmean ns\tp50 ns\tp99 ns\tmax ns\tcallbacks/s (M)\n";
+  for (const std::size_t num_subs :
+       {1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u}) {
+    const std::size_t samples = std::clamp<std::size_t>(
+        10'000'000 / num_subs, std::size_t{20}, std::size_t{100'000});
+
+    Observable<int> obs;
+    std::vector<Subscription> subs;
+    subs.reserve(num_subs);
+    for (std::size_t s{0}; s < num_subs; ++s) {
+      subs.push_back(obs.Subscribe([](int v) { g_sink = g_sink + v; }));
+    }
+
+    std::vector<double> timings(samples);
+    for (std::size_t i{0}; i < samples; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      obs = static_cast<int>(i);
+      const auto stop = std::chrono::steady_clock::now();
+      timings[i] = std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+
+    double total{0};
+    for (const auto t : timings) {
+      total += t;
+    }
+    std::sort(timings.begin(), timings.end());
+    const auto mean = total / static_cast<double>(samples);
+    const auto callbacks_per_sec =
+        static_cast<double>(num_subs) * 1e9 / mean;
+    std::cout << num_subs << '\t' << mean << '\t' << timings[samples / 2]
+              << '\t' << timings[samples * 99 / 100] << '\t' << timings.back()
+              << '\t' << callbacks_per_sec / 1e6 << '\n';
+  }
+}
+
+template <std::size_t NBytes>
+void payload_row(std::size_t num_subs) {
+  using Value = Blob<NBytes>;
+  const std::size_t iters = 2'000'000 / (num_subs + NBytes / 64) + 10;
+
+  ByValueObservable<Value> legacy;
+  Observable<Value> current;
+  std::vector<Subscription> subs;
+  for (std::size_t s{0}; s < num_subs; ++s) {
+    legacy.Subscribe([s](Value p) { g_sink = g_sink + p.bytes[s % NBytes]; });
+    subs.push_back(current.Subscribe(
+        [s](const Value& p) { g_sink = g_sink + p.bytes[s % NBytes]; }));
+  }
+
+  Value payload{};
+  const auto legacy_ns = time_ns_per_iter(iters, [&](std::size_t i) {
+    payload.bytes[0] = static_cast<std::uint8_t>(i);
+    legacy = payload;
+  });
+  const auto current_ns = time_ns_per_iter(iters, [&](std::size_t i) {
+    payload.bytes[0] = static_cast<std::uint8_t>(i);
+    current = payload;
+  });
+  std::cout << NBytes << '\t' << legacy_ns << '\t' << current_ns << '\n';
+}
+
+void bench_payload_size() {
+  std::cout << "payload size sweep, 100 subscribers (ns per update)\n";
+  std::cout << "bytes\tby-value\tby-ref\n";
+  payload_row<8>(100);
+  payload_row<64>(100);
+  payload_row<1024>(100);
+  payload_row<16384>(100);
+}
+
+void bench_updater_cost() {
+  std::cout << "updater cost, 1 KiB payload, 100 subscribers (ns per update)\n";
+  std::cout << "repeat rate\tassign\tcompare\n";
+  constexpr std::size_t iters{200'000};
+  constexpr std::size_t num_subs{100};
+  // How often the written value equals the current one
+  for (const std::size_t repeat_every : {1u, 2u, 10u, 1000000u}) {
+    Observable<Payload> assign;
+    Observable<Payload, CompareUpdater<Payload>> compare;
+    std::vector<Subscription> subs;
+    for (std::size_t s{0}; s < num_subs; ++s) {
+      subs.push_back(
+          assign.Subscribe([](const Payload& p) { g_sink = g_sink + p.bytes[0]; }));
+      subs.push_back(compare.Subscribe(
+          [](const Payload& p) { g_sink = g_sink + p.bytes[0]; }));
+    }
+
+    Payload payload{};
+    const auto next = [&](std::size_t i) -> const Payload& {
+      if (i % repeat_every != 0) {
+        payload.bytes[1] = static_cast<std::uint8_t>(payload.bytes[1] + 1);
+      }
+      return payload;
+    };
+    const auto assign_ns = time_ns_per_iter(
+        iters, [&](std::size_t i) { assign.Update(next(i)); });
+    payload = Payload{};
+    const auto compare_ns = time_ns_per_iter(
+        iters, [&](std::size_t i) { compare.Update(next(i)); });
+    const auto repeats = repeat_every == 1 ? std::string{"all"}
+                                           : "1/" + std::to_string(repeat_every);
+    std::cout << repeats << '\t' << assign_ns << '\t' << compare_ns;
+#ifdef OBSERVABLE_ENABLE_STATS
+    const auto stats = compare.Stats();
+    std::cout << "\t(sent " << stats.notifications << ", suppressed "
+              << stats.suppressed_updates << ')';
+#endif
+    std::cout << '\n';
+  }
+}
+
+void bench_instrumentation() {
+#ifdef OBSERVABLE_ENABLE_STATS
+  std::cout << "instrumentation: one slow subscriber among 1000\n";
+  Observable<int> obs;
+  std::vector<Subscription> subs;
+  for (std::size_t s{0}; s < 1000; ++s) {
+    if (s == 637) {
+      subs.push_back(obs.Subscribe([](int v) {
+        for (int spin{0}; spin < 2000; ++spin) {
+          g_sink = g_sink + v;
+        }
+      }));
+    } else {
+      subs.push_back(obs.Subscribe([](int v) { g_sink = g_sink + v; }));
+    }
+  }
+  {
+    auto tx = obs.BeginTransaction();
+    obs = -1;
+    obs = -2;
+  }
+  for (int i{0}; i < 1000; ++i) {
+    obs = i;
+  }
+
+  SubscriptionKey slowest{};
+  SubscriberStats worst{};
+  obs.ForEachSubscriberStats(
+      [&](SubscriptionKey key, const SubscriberStats& stats) {
+        if (stats.total_ns > worst.total_ns) {
+          slowest = key;
+          worst = stats;
+        }
+      });
+  const auto stats = obs.Stats();
+  std::cout << "notifications " << stats.notifications << ", coalesced "
+            << stats.coalesced_changes << ", suppressed "
+            << stats.suppressed_updates << '\n';
+  std::cout << "slowest subscriber slot " << slowest.index << ": "
+            << worst.calls << " calls, mean "
+            << worst.total_ns / std::max<std::uint64_t>(worst.calls, 1)
+            << " ns, max " << worst.max_ns << " ns\n";
+#else
+  std::cout << "instrumentation: rebuild with -DOBSERVABLE_ENABLE_STATS\n";
+#endif
+}
+
+void bench_subscribe_churn() {
+  std::cout << "subscribe/unsubscribe churn, 1M cycles (ns per cycle)\n";
+  std::cout << "resident\tchurn only\tnotify every 16\n";
+  constexpr std::size_t cycles{1'000'000};
+  for (const std::size_t resident : {0u, 100u, 10000u}) {
+    Observable<int> obs;
+    std::vector<Subscription> subs;
+    for (std::size_t s{0}; s < resident; ++s) {
+      subs.push_back(obs.Subscribe([](int v) { g_sink = g_sink + v; }));
+    }
+
+    const auto churn_ns = time_ns_per_iter(cycles, [&](std::size_t i) {
+      auto sub = obs.Subscribe([i](int v) { g_sink = g_sink + v + i; });
+    });
+    const auto mixed_ns = time_ns_per_iter(cycles, [&](std::size_t i) {
+      auto sub = obs.Subscribe([i](int v) { g_sink = g_sink + v + i; });
+      if (i % 16 == 0) {
+        obs = static_cast<int>(i);
+      }
+    });
+    std::cout << resident << '\t' << churn_ns << '\t' << mixed_ns << '\n';
+  }
+}
+
+void bench_unsubscribe_during_notify() {
+  std::cout << "every subscriber unsubscribes itself mid-notify (ns per sub)\n";
+  constexpr std::size_t num_subs{100'000};
+  Observable<int> obs;
+  std::vector<Subscription> subs(num_subs);
+  for (std::size_t s{0}; s < num_subs; ++s) {
+    subs[s] = obs.Subscribe([&subs, s](int v) {
+      g_sink = g_sink + v;
+      subs[s].Unsubscribe();
+    });
+  }
+  const auto ns = time_ns_per_iter(1, [&](std::size_t) { obs = 1; });
+  std::cout << ns / num_subs << " (remaining " << obs.SubscriberCount()
+            << ")\n";
+}
+
+void bench_transaction_coalescing() {
+  std::cout << "500 field updates per tick, 100 subscribers (ns per tick)\n";
+  std::cout << "immediate\ttransaction\n";
+  constexpr std::size_t ticks{1000};
+  Observable<Payload> obs;
+  std::vector<Subscription> subs;
+  for (std::size_t s{0}; s < 100; ++s) {
+    subs.push_back(obs.Subscribe(
+        [s](const Payload& p) { g_sink = g_sink + p.bytes[s % 1024]; }));
+  }
+
+  Payload payload{};
+  const auto immediate_ns = time_ns_per_iter(ticks, [&](std::size_t i) {
+    for (std::size_t field{0}; field < 500; ++field) {
+      payload.bytes[field] = static_cast<std::uint8_t>(i);
+      obs = payload;
+    }
+  });
+  const auto tx_ns = time_ns_per_iter(ticks, [&](std::size_t i) {
+    auto tx = obs.BeginTransaction();
+    for (std::size_t field{0}; field < 500; ++field) {
+      payload.bytes[field] = static_cast<std::uint8_t>(i);
+      obs = payload;
+    }
+  });
+  std::cout << immediate_ns << '\t' << tx_ns << '\n';
+}
+
+void bench_async_dispatch() {
+  std::cout << "updater-side cost with a 20us subscriber (ns per update)\n";
+  std::cout << "sync\tasync\tdelivered/sent\n";
+  constexpr std::size_t updates{2000};
+  const auto slow = [](const Payload& p) {
+    g_sink = g_sink + p.bytes[0];
+    std::this_thread::sleep_for(std::chrono::microseconds{20});
+  };
+
+  Observable<Payload> sync_obs;
+  auto sync_sub = sync_obs.Subscribe(slow);
+  Payload payload{};
+  const auto sync_ns = time_ns_per_iter(updates, [&](std::size_t i) {
+    payload.bytes[0] = static_cast<std::uint8_t>(i);
+    sync_obs = payload;
+  });
+
+  std::size_t delivered{0};
+  double async_ns{0};
+  {
+    auto executor = std::make_shared<BatchExecutor>(2);
+    Observable<Payload> async_obs;
+    async_obs.DispatchOn(executor);
+    auto async_sub = async_obs.Subscribe([&](const Payload& p) {
+      ++delivered;
+      slow(p);
+    });
+    async_ns = time_ns_per_iter(updates, [&](std::size_t i) {
+      payload.bytes[0] = static_cast<std::uint8_t>(i);
+      async_obs = payload;
+    });
+    // Dropping the last executor reference drains the queue before returning
+    async_obs.DispatchOn(nullptr);
+    executor.reset();
+  }
+  std::cout << sync_ns << '\t' << async_ns << '\t' << delivered << '/'
+            << updates << '\n';
+}
+
+template <typename THeadFunc>
+double time_computed_chain(std::size_t depth, std::size_t updates,
+                           THeadFunc head_func) {
+  Observable<int> source;
+  std::vector<std::unique_ptr<Computed<int>>> chain;
+  chain.push_back(std::make_unique<Computed<int>>(head_func, source));
+  for (std::size_t lvl{1}; lvl < depth; ++lvl) {
+    chain.push_back(std::make_unique<Computed<int>>(
+        [](int prev) { return prev + 1; }, *chain.back()));
+  }
+  auto sub = chain.back()->Subscribe(
+      [](int v) { g_sink = g_sink + static_cast<std::uint64_t>(v); });
+  return time_ns_per_iter(updates,
+                          [&](std::size_t i) { source = static_cast<int>(i); });
+}
+
+void bench_computed_deep_chain() {
+  std::cout << "computed chain, depth 1000, observed tail (ns per update)\n";
+  std::cout << "hand-written\tcomputed\tcomputed w/ cut-off at depth 1\n";
+  constexpr std::size_t depth{1000};
+  constexpr std::size_t updates{2000};
+
+  std::vector<int> levels(depth);
+  const auto hand_ns = time_ns_per_iter(updates, [&](std::size_t i) {
+    levels[0] = static_cast<int>(i);
+    for (std::size_t lvl{1}; lvl < depth; ++lvl) {
+      levels[lvl] = levels[lvl - 1] + 1;
+    }
+    g_sink = g_sink + static_cast<std::uint64_t>(levels.back());
+  });
+
+  const auto computed_ns =
+      time_computed_chain(depth, updates, [](int v) { return v; });
+  const auto cutoff_ns =
+      time_computed_chain(depth, updates, [](int v) { return v / 1000; });
+  std::cout << hand_ns << '\t' << computed_ns << '\t' << cutoff_ns << '\n';
+}
+
+void bench_computed_wide() {
+  std::cout << "1 source, 1000 derived values (ns per update)\n";
+  std::cout << "hand-written\tall observed\tunobserved, read 1\n";
+  constexpr std::size_t width{1000};
+  constexpr std::size_t updates{2000};
+
+  std::vector<int> derived(width);
+  const auto hand_ns = time_ns_per_iter(updates, [&](std::size_t i) {
+    for (std::size_t idx{0}; idx < width; ++idx) {
+      derived[idx] = static_cast<int>(i * idx);
+    }
+    g_sink = g_sink + static_cast<std::uint64_t>(derived[7]);
+  });
+
+  Observable<int> source;
+  std::vector<std::unique_ptr<Computed<int>>> wide;
+  for (std::size_t idx{0}; idx < width; ++idx) {
+    wide.push_back(std::make_unique<Computed<int>>(
+        [idx](int v) { return v * static_cast<int>(idx); }, source));
+  }
+
+  const auto lazy_ns = time_ns_per_iter(updates, [&](std::size_t i) {
+    source = static_cast<int>(i);
+    g_sink = g_sink + static_cast<std::uint64_t>(wide[7]->Value());
+  });
+
+  std::vector<Subscription> subs;
+  for (auto& node : wide) {
+    subs.push_back(node->Subscribe(
+        [](int v) { g_sink = g_sink + static_cast<std::uint64_t>(v); }));
+  }
+  const auto observed_ns = time_ns_per_iter(
+      updates, [&](std::size_t i) { source = static_cast<int>(i); });
+  std::cout << hand_ns << '\t' << observed_ns << '\t' << lazy_ns << '\n';
+}
+
+void bench_container_diffs() {
+  std::cout << "single-element change, 10 mirroring subscribers "
+               "(ns per change)\n";
+  std::cout << "size\tvector whole\tvector diff\tmap whole\tmap diff\n";
+  constexpr std::size_t num_subs{10};
+  for (const std::size_t size : {100u, 10000u, 100000u}) {
+    const std::size_t changes = 2'000'000 / size + 10;
+
+    Observable<std::vector<int>> whole_vec{std::vector<int>(size)};
+    std::vector<std::vector<int>> whole_vec_mirrors(num_subs);
+    std::vector<Subscription> subs;
+    for (auto& mirror : whole_vec_mirrors) {
+      subs.push_back(whole_vec.Subscribe(
+          [&mirror](const std::vector<int>& v) { mirror = v; }));
+    }
+    const auto whole_vec_ns = time_ns_per_iter(changes, [&](std::size_t i) {
+      auto next = whole_vec.Value();
+      next[i % size] = static_cast<int>(i);
+      whole_vec = std::move(next);
+    });
+
+    ObservableVector<int> diff_vec{std::vector<int>(size)};
+    std::vector<std::vector<int>> diff_vec_mirrors(num_subs,
+                                                   std::vector<int>(size));
+    for (auto& mirror : diff_vec_mirrors) {
+      subs.push_back(diff_vec.Subscribe(
+          [&mirror](std::span<const VectorChange<int>> changes) {
+            ApplyChanges(mirror, changes);
+          }));
+    }
+    const auto diff_vec_ns = time_ns_per_iter(changes, [&](std::size_t i) {
+      diff_vec.Set(i % size, static_cast<int>(i));
+    });
+
+    std::unordered_map<std::size_t, int> initial;
+    for (std::size_t key{0}; key < size; ++key) {
+      initial.emplace(key, 0);
+    }
+
+    Observable<std::unordered_map<std::size_t, int>> whole_map{initial};
+    std::vector<std::unordered_map<std::size_t, int>> whole_map_mirrors(
+        num_subs);
+    for (auto& mirror : whole_map_mirrors) {
+      subs.push_back(whole_map.Subscribe(
+          [&mirror](const std::unordered_map<std::size_t, int>& m) {
+            mirror = m;
+          }));
+    }
+    const auto whole_map_ns = time_ns_per_iter(changes / 10 + 1,
+                                               [&](std::size_t i) {
+      auto next = whole_map.Value();
+      next[i % size] = static_cast<int>(i);
+      whole_map = std::move(next);
+    });
+
+    ObservableMap<std::size_t, int> diff_map{initial};
+    std::vector<std::unordered_map<std::size_t, int>> diff_map_mirrors(
+        num_subs, initial);
+    for (auto& mirror : diff_map_mirrors) {
+      subs.push_back(diff_map.Subscribe(
+          [&mirror](std::span<const MapChange<std::size_t, int>> changes) {
+            ApplyChanges(mirror, changes);
+          }));
+    }
+    const auto diff_map_ns = time_ns_per_iter(changes, [&](std::size_t i) {
+      diff_map.InsertOrAssign(i % size, static_cast<int>(i));
+    });
+
+    std::cout << size << '\t' << whole_vec_ns << '\t' << diff_vec_ns << '\t'
+              << whole_map_ns << '\t' << diff_map_ns << '\n';
+  }
+}
+
+struct Quote {
+  double bid;
+  double ask;
+  double last;
+  std::uint64_t sequence;
+  std::array<double, 4> depth;
+};
+
+// Runs a writer flat out against num_readers pollers for a fixed window and
+// returns total reads per second across all readers
+template <typename TWrite, typename TRead>
+double reads_per_second(std::size_t num_readers, TWrite&& write, TRead&& read) {
+  std::atomic<bool> stop{false};
+  std::atomic<std::uint64_t> total_reads{0};
+  std::atomic<std::uint64_t> checksum{0};
+  std::vector<std::thread> readers;
+  for (std::size_t r{0}; r < num_readers; ++r) {
+    readers.emplace_back([&] {
+      std::uint64_t reads{0};
+      std::uint64_t sum{0};
+      while (!stop.load(std::memory_order_relaxed)) {
+        sum += read();
+        ++reads;
+      }
+      total_reads.fetch_add(reads);
+      checksum.fetch_add(sum);
+    });
+  }
+  std::thread writer([&] {
+    for (std::uint64_t i{0}; !stop.load(std::memory_order_relaxed); ++i) {
+      write(i);
+    }
+  });
+
+  constexpr auto window = std::chrono::milliseconds{200};
+  std::this_thread::sleep_for(window);
+  stop = true;
+  writer.join();
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  g_sink = g_sink + checksum.load();
+  return static_cast<double>(total_reads.load()) /
+         std::chrono::duration<double>(window).count();
+}
+
+void bench_read_mostly_scaling() {
+  std::cout << "cross-thread polling with one writer (M reads/s, all readers)\n";
+  std::cout << "readers\tmutex\tseqlock\tmutex string\tsnapshot string\n";
+  for (const std::size_t num_readers : {1u, 2u, 4u, 8u}) {
+    std::mutex mutex;
+    Quote guarded{};
+    const auto mutex_rps = reads_per_second(
+        num_readers,
+        [&](std::uint64_t i) {
+          std::lock_guard lock{mutex};
+          guarded.sequence = i;
+        },
+        [&] {
+          std::lock_guard lock{mutex};
+          return guarded.sequence;
+        });
+
+    ReadMostlyObservable<Quote> quote;
+    const auto seqlock_rps = reads_per_second(
+        num_readers, [&](std::uint64_t i) { quote = Quote{0, 0, 0, i, {}}; },
+        [&] { return quote.Load().sequence; });
+
+    std::string guarded_str;
+    const auto mutex_str_rps = reads_per_second(
+        num_readers,
+        [&](std::uint64_t i) {
+          auto next = std::to_string(i);
+          std::lock_guard lock{mutex};
+          guarded_str = std::move(next);
+        },
+        [&] {
+          std::string copy;
+          {
+            std::lock_guard lock{mutex};
+            copy = guarded_str;
+          }
+          return copy.size();
+        });
+
+    ReadMostlyObservable<std::string> str;
+    const auto snapshot_rps = reads_per_second(
+        num_readers, [&](std::uint64_t i) { str = std::to_string(i); },
+        [&] { return str.Load()->size(); });
+
+    std::cout << num_readers << '\t' << mutex_rps / 1e6 << '\t'
+              << seqlock_rps / 1e6 << '\t' << mutex_str_rps / 1e6 << '\t'
+              << snapshot_rps / 1e6 << '\n';
+  }
+}
+
+struct Tick {
+  std::uint64_t sequence;
+  std::uint64_t padding[7];
+};
+
+// Attaches once the other process has published name, or gives up after a
+// couple of seconds
+template <typename TValueType>
+std::unique_ptr<SharedObservableView<TValueType>> attach_when_ready(
+    const std::string& name) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds{2};
+  for (;;) {
+    try {
+      return std::make_unique<SharedObservableView<TValueType>>(name);
+    } catch (const std::runtime_error&) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        throw;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds{50});
+    }
+  }
+}
+
+// Echoes every ping back as a pong until the ping publisher closes. Pong is
+// only published once ping is attached, so no ping can arrive before the view
+// exists and go undelivered
+void shared_echo(const std::string& ping_name, const std::string& pong_name,
+                 std::uint32_t spins) {
+  auto ping = attach_when_ready<Tick>(ping_name);
+  SharedObservable<Tick> pong{pong_name};
+  auto sub = ping->Subscribe([&pong](const Tick& tick) { pong = tick; });
+  while (!ping->Closed()) {
+    ping->Wait(std::chrono::milliseconds{100}, spins);
+  }
+}
+
+void print_round_trips(const char* label, std::vector<double>& timings) {
+  std::sort(timings.begin(), timings.end());
+  const auto samples = timings.size();
+  std::cout << label << '\t' << timings[samples / 2] / 1000 << '\t'
+            << timings[samples * 99 / 100] / 1000 << '\t'
+            << timings.back() / 1000 << '\n';
+}
+
+// Round trips through a SharedObservable in each direction, so both the
+// publish and the wake-up are paid twice
+void shared_round_trips(const char* label, std::uint32_t spins,
+                        std::size_t samples) {
+  const auto suffix = std::to_string(::getpid());
+  const std::string ping_name{"/observable_bench_ping." + suffix};
+  const std::string pong_name{"/observable_bench_pong." + suffix};
+
+  std::vector<double> timings(samples);
+  pid_t child{0};
+  bool lost{false};
+  {
+    SharedObservable<Tick> ping{ping_name};
+    std::cout.flush();
+    child = ::fork();
+    if (child == 0) {
+      shared_echo(ping_name, pong_name, spins);
+      _exit(0);
+    }
+    auto pong = attach_when_ready<Tick>(pong_name);
+    std::uint64_t echoed{0};
+    auto sub = pong->Subscribe(
+        [&echoed](const Tick& tick) { echoed = tick.sequence; });
+    for (std::size_t i{0}; i < samples && !lost; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      const auto deadline = start + std::chrono::seconds{2};
+      ping = Tick{i + 1, {}};
+      while (echoed != i + 1 && !lost) {
+        pong->Wait(std::chrono::milliseconds{100}, spins);
+        lost = echoed != i + 1 && std::chrono::steady_clock::now() > deadline;
+      }
+      const auto stop = std::chrono::steady_clock::now();
+      timings[i] =
+          std::chrono::duration<double, std::nano>(stop - start).count();
+    }
+    // Destroying ping wakes the echo process so it can exit
+  }
+  ::waitpid(child, nullptr, 0);
+  if (lost) {
+    throw std::runtime_error("no echo within 2 s; a ping was lost");
+  }
+  print_round_trips(label, timings);
+}
+
+// The same exchange over a pair of pipes, as the usual alternative
+void pipe_round_trips(std::size_t samples) {
+  int to_child[2];
+  int to_parent[2];
+  if (::pipe(to_child) != 0 || ::pipe(to_parent) != 0) {
+    return;
+  }
+  std::cout.flush();
+  const pid_t child = ::fork();
+  if (child == 0) {
+    ::close(to_child[1]);
+    ::close(to_parent[0]);
+    Tick tick{};
+    while (::read(to_child[0], &tick, sizeof tick) == sizeof tick) {
+      [[maybe_unused]] const auto sent =
+          ::write(to_parent[1], &tick, sizeof tick);
+    }
+    _exit(0);
+  }
+  ::close(to_child[0]);
+  ::close(to_parent[1]);
+  std::vector<double> timings(samples);
+  for (std::size_t i{0}; i < samples; ++i) {
+    Tick tick{i + 1, {}};
+    const auto start = std::chrono::steady_clock::now();
+    [[maybe_unused]] const auto sent =
+        ::write(to_child[1], &tick, sizeof tick);
+    [[maybe_unused]] const auto got = ::read(to_parent[0], &tick, sizeof tick);
+    const auto stop = std::chrono::steady_clock::now();
+    timings[i] = std::chrono::duration<double, std::nano>(stop - start).count();
+  }
+  ::close(to_child[1]);
+  ::close(to_parent[0]);
+  ::waitpid(child, nullptr, 0);
+  print_round_trips("pipe", timings);
+}
+
+void bench_shared_round_trip() {
+  constexpr std::size_t samples{20'000};
+  std::cout << "two-process round trip, 64 B payload (us)\n";
+  std::cout << "wait\tp50\tp99\tmax\n";
+  shared_round_trips("futex", 0, samples);
+  shared_round_trips("spin 10k, then futex", 10'000, samples);
+  pipe_round_trips(samples);
+}
+
+}  // namespace
+
+// Pass section names to run only those, e.g. "notify_latency updater_cost"
+int main(int argc, char** argv) {
+  struct Section {
+    std::string_view name;
+    void (*run)();
+  };
+  static constexpr Section sections[]{
+      {"notify_fan_out", bench_notify_fan_out},
+      {"notify_latency", bench_notify_latency},
+      {"payload_size", bench_payload_size},
+      {"updater_cost", bench_updater_cost},
+      {"instrumentation", bench_instrumentation},
+      {"subscribe_churn", bench_subscribe_churn},
+      {"unsubscribe_during_notify", bench_unsubscribe_during_notify},
+      {"transaction_coalescing", bench_transaction_coalescing},
+      {"async_dispatch", bench_async_dispatch},
+      {"computed_deep_chain", bench_computed_deep_chain},
+      {"computed_wide", bench_computed_wide},
+      {"container_diffs", bench_container_diffs},
+      {"read_mostly_scaling", bench_read_mostly_scaling},
+      {"shared_round_trip", bench_shared_round_trip},
+  };
+  for (const auto& section : sections) {
+    const bool selected =
+        argc < 2 || std::any_of(argv + 1, argv + argc, [&](const char* arg) {
+          return section.name == arg;
+        });
+    if (!selected) {
+      continue;
+    }
+    try {
+      section.run();
+    } catch (const std::exception& error) {
+      std::cerr << section.name << ": " << error.what() << '\n';
+      return 1;
+    }
+  }
+}
@@ -0,0 +1,404 @@
+/**
+ * @brief Observable containers that publish change records, not whole values
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef OBSERVABLE_CONTAINERS_HPP
+#define OBSERVABLE_CONTAINERS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "observable.hpp"
+
+enum class ChangeKind : std::uint8_t { Insert, Erase, Update };
+
+/**
+ * @brief A contiguous run of inserted, erased or overwritten elements
+ *
+ * Insert and Update carry the new values for [index, index + values.size());
+ * Erase removes count elements starting at index.
+ */
+template <typename TValueType>
+struct VectorChange {
+  ChangeKind kind;
+  std::size_t index;
+  std::size_t count;
+  std::vector<TValueType> values;
+};
+
+template <typename TKey, typename TValue>
+struct MapChange {
+  ChangeKind kind;
+  TKey key;
+  // Empty for Erase
+  std::optional<TValue> value;
+};
+
+/**
+ * @brief Replay a batch of changes onto a subscriber-owned copy
+ */
+template <typename TValueType>
+void ApplyChanges(std::vector<TValueType>& mirror,
+                  std::span<const VectorChange<TValueType>> changes) {
+  for (const auto& change : changes) {
+    const auto first = mirror.begin() + static_cast<std::ptrdiff_t>(change.index);
+    switch (change.kind) {
+      case ChangeKind::Insert:
+        mirror.insert(first, change.values.begin(), change.values.end());
+        break;
+      case ChangeKind::Erase:
+        mirror.erase(first, first + static_cast<std::ptrdiff_t>(change.count));
+        break;
+      case ChangeKind::Update:
+        std::copy(change.values.begin(), change.values.end(), first);
+        break;
+    }
+  }
+}
+
+template <typename TKey, typename TValue, typename... TMapArgs>
+void ApplyChanges(std::unordered_map<TKey, TValue, TMapArgs...>& mirror,
+                  std::span<const MapChange<TKey, TValue>> changes) {
+  for (const auto& change : changes) {
+    if (change.kind == ChangeKind::Erase) {
+      mirror.erase(change.key);
+    } else {
+      mirror.insert_or_assign(change.key, *change.value);
+    }
+  }
+}
+
+/**
+ * @brief Shared plumbing: subscribers, transactions and the pending batch
+ *
+ * Outside a transaction every mutation is published on its own. Inside one,
+ * TDerived::Coalesce folds each change into the pending batch, which is
+ * published once when the outermost transaction ends.
+ */
+template <typename TDerived, typename TChange>
+class ChangePublisher {
+public:
+  using Change = TChange;
+  using Callback = InplaceFunction<void(std::span<const TChange>)>;
+
+  class Transaction {
+  public:
+    explicit Transaction(ChangePublisher& pub) noexcept : m_pub{&pub} {
+      ++pub.m_tx_depth;
+    }
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    Transaction(Transaction&& other) noexcept
+        : m_pub{std::exchange(other.m_pub, nullptr)} {}
+    Transaction& operator=(Transaction&&) = delete;
+
+    ~Transaction() { Commit(); }
+
+    void Commit() {
+      if (auto* pub = std::exchange(m_pub, nullptr);
+          pub != nullptr && --pub->m_tx_depth == 0) {
+        pub->Publish();
+      }
+    }
+
+  private:
+    ChangePublisher* m_pub;
+  };
+
+  ChangePublisher() = default;
+  ChangePublisher(const ChangePublisher&) = delete;
+  ChangePublisher& operator=(const ChangePublisher&) = delete;
+  ChangePublisher(ChangePublisher&&) noexcept = default;
+  ChangePublisher& operator=(ChangePublisher&&) noexcept = default;
+
+  template <typename TFunc>
+  [[nodiscard]] Subscription Subscribe(TFunc&& func)
+    requires std::is_invocable_v<std::decay_t<TFunc>&,
+                                 std::span<const TChange>>
+  {
+    const auto key = Subscribers().Insert(std::forward<TFunc>(func));
+    return {std::weak_ptr<SubscriptionOwner>{m_subs}, key};
+  }
+
+  bool Unsubscribe(SubscriptionKey key) noexcept {
+    return m_subs && m_subs->Unsubscribe(key);
+  }
+
+  [[nodiscard]] std::size_t SubscriberCount() const noexcept {
+    return m_subs ? m_subs->Size() : 0;
+  }
+
+  [[nodiscard]] Transaction BeginTransaction() noexcept {
+    return Transaction{*this};
+  }
+
+protected:
+  ~ChangePublisher() = default;
+
+  void Record(TChange&& change) {
+    if (m_tx_depth == 0) {
+      m_pending.push_back(std::move(change));
+      Publish();
+    } else if (m_pending.empty() ||
+               !static_cast<TDerived&>(*this).Coalesce(m_pending, change)) {
+      m_pending.push_back(std::move(change));
+    }
+  }
+
+private:
+  // A moved-from container has no slot map; subscribing to it again starts
+  // a fresh one
+  SubscriberSlotMap<Callback>& Subscribers() {
+    if (!m_subs) {
+      m_subs = std::make_shared<SubscriberSlotMap<Callback>>();
+    }
+    return *m_subs;
+  }
+
+  void Publish() {
+    if (m_pending.empty()) {
+      return;
+    }
+    // Swapped out so that a subscriber mutating the container starts a fresh
+    // batch instead of appending to the one being delivered
+    auto batch = std::move(m_pending);
+    m_pending.clear();
+    if (m_subs) {
+      m_subs->Invoke(std::span<const TChange>{batch});
+    }
+    if (m_pending.empty()) {
+      batch.clear();
+      m_pending = std::move(batch);
+    }
+  }
+
+  std::shared_ptr<SubscriberSlotMap<Callback>> m_subs{
+      std::make_shared<SubscriberSlotMap<Callback>>()};
+  std::vector<TChange> m_pending;
+  std::uint32_t m_tx_depth{0};
+};
+
+/**
+ * @brief std::vector whose subscribers receive VectorChange batches
+ *
+ * Within a transaction, runs of appends, overwrites of contiguous or recently
+ * inserted elements and repeated erases at one position collapse into a
+ * single record each.
+ */
+template <typename TValueType>
+class ObservableVector
+    : public ChangePublisher<ObservableVector<TValueType>,
+                             VectorChange<TValueType>> {
+  using Base =
+      ChangePublisher<ObservableVector<TValueType>, VectorChange<TValueType>>;
+  friend Base;
+
+public:
+  ObservableVector() = default;
+  explicit ObservableVector(std::vector<TValueType> values)
+      : m_values{std::move(values)} {}
+
+  [[nodiscard]] const std::vector<TValueType>& Value() const noexcept {
+    return m_values;
+  }
+  [[nodiscard]] std::size_t Size() const noexcept { return m_values.size(); }
+  [[nodiscard]] const TValueType& operator[](std::size_t idx) const {
+    return m_values[idx];
+  }
+
+  void PushBack(TValueType value) { Insert(m_values.size(), std::move(value)); }
+
+  void Insert(std::size_t idx, TValueType value) {
+    m_values.insert(m_values.begin() + static_cast<std::ptrdiff_t>(idx), value);
+    std::vector<TValueType> values;
+    values.push_back(std::move(value));
+    this->Record({ChangeKind::Insert, idx, 1, std::move(values)});
+  }
+
+  void Set(std::size_t idx, TValueType value) {
+    m_values[idx] = value;
+    std::vector<TValueType> values;
+    values.push_back(std::move(value));
+    this->Record({ChangeKind::Update, idx, 1, std::move(values)});
+  }
+
+  void Erase(std::size_t idx, std::size_t count = 1) {
+    const auto first = m_values.begin() + static_cast<std::ptrdiff_t>(idx);
+    m_values.erase(first, first + static_cast<std::ptrdiff_t>(count));
+    this->Record({ChangeKind::Erase, idx, count, {}});
+  }
+
+  void Clear() {
+    if (!m_values.empty()) {
+      Erase(0, m_values.size());
+    }
+  }
+
+private:
+  static bool Coalesce(std::vector<VectorChange<TValueType>>& pending,
+                       VectorChange<TValueType>& change) {
+    auto& last = pending.back();
+    const auto last_end = last.index + last.count;
+    switch (change.kind) {
+      case ChangeKind::Insert:
+        if (last.kind == ChangeKind::Insert && change.index >= last.index &&
+            change.index <= last_end) {
+          last.values.insert(
+              last.values.begin() +
+                  static_cast<std::ptrdiff_t>(change.index - last.index),
+              std::move(change.values.front()));
+          ++last.count;
+          return true;
+        }
+        return false;
+      case ChangeKind::Update:
+        if (last.kind != ChangeKind::Erase && change.index >= last.index &&
+            change.index < last_end) {
+          last.values[change.index - last.index] =
+              std::move(change.values.front());
+          return true;
+        }
+        if (last.kind == ChangeKind::Update && change.index == last_end) {
+          last.values.push_back(std::move(change.values.front()));
+          ++last.count;
+          return true;
+        }
+        return false;
+      case ChangeKind::Erase:
+        if (last.kind == ChangeKind::Erase &&
+            (change.index == last.index ||
+             change.index + change.count == last.index)) {
+          last.index = change.index;
+          last.count += change.count;
+          return true;
+        }
+        // Erasing what this batch just inserted cancels out
+        if (last.kind == ChangeKind::Insert && change.index >= last.index &&
+            change.index + change.count <= last_end) {
+          const auto first = last.values.begin() +
+                             static_cast<std::ptrdiff_t>(change.index -
+                                                         last.index);
+          last.values.erase(first,
+                            first + static_cast<std::ptrdiff_t>(change.count));
+          last.count -= change.count;
+          if (last.count == 0) {
+            pending.pop_back();
+          }
+          return true;
+        }
+        return false;
+    }
+    return false;
+  }
+
+  std::vector<TValueType> m_values;
+};
+
+/**
+ * @brief std::unordered_map whose subscribers receive MapChange batches
+ *
+ * Within a transaction each key keeps at most one record carrying its net
+ * effect, e.g. an insert followed by an erase of the same key cancels out.
+ */
+template <typename TKey, typename TValue, typename THash = std::hash<TKey>,
+          typename TKeyEqual = std::equal_to<TKey>>
+class ObservableMap
+    : public ChangePublisher<ObservableMap<TKey, TValue, THash, TKeyEqual>,
+                             MapChange<TKey, TValue>> {
+  using Base = ChangePublisher<ObservableMap<TKey, TValue, THash, TKeyEqual>,
+                               MapChange<TKey, TValue>>;
+  friend Base;
+
+public:
+  using Map = std::unordered_map<TKey, TValue, THash, TKeyEqual>;
+
+  ObservableMap() = default;
+  explicit ObservableMap(Map values) : m_values{std::move(values)} {}
+
+  [[nodiscard]] const Map& Value() const noexcept { return m_values; }
+  [[nodiscard]] std::size_t Size() const noexcept { return m_values.size(); }
+  [[nodiscard]] bool Contains(const TKey& key) const {
+    return m_values.contains(key);
+  }
+  [[nodiscard]] const TValue* Find(const TKey& key) const {
+    const auto it = m_values.find(key);
+    return it == m_values.end() ? nullptr : &it->second;
+  }
+
+  void InsertOrAssign(const TKey& key, TValue value) {
+    const auto [it, inserted] = m_values.insert_or_assign(key, value);
+    this->Record({inserted ? ChangeKind::Insert : ChangeKind::Update, key,
+                  std::move(value)});
+  }
+
+  bool Erase(const TKey& key) {
+    if (m_values.erase(key) == 0) {
+      return false;
+    }
+    this->Record({ChangeKind::Erase, key, std::nullopt});
+    return true;
+  }
+
+  void Clear() {
+    auto tx = this->BeginTransaction();
+    while (!m_values.empty()) {
+      // Copied out, the node holding it is freed by the erase
+      const TKey key = m_values.begin()->first;
+      Erase(key);
+    }
+  }
+
+private:
+  bool Coalesce(std::vector<MapChange<TKey, TValue>>& pending,
+                MapChange<TKey, TValue>& change) {
+    if (pending.size() == 1) {
+      m_pending_index.clear();
+      m_pending_index.emplace(pending.front().key, 0);
+    }
+    const auto it = m_pending_index.find(change.key);
+    if (it == m_pending_index.end()) {
+      m_pending_index.emplace(change.key, pending.size());
+      return false;
+    }
+
+    auto& prior = pending[it->second];
+    if (prior.kind == ChangeKind::Insert && change.kind == ChangeKind::Erase) {
+      // Never visible to subscribers, so drop the record; per-key records are
+      // independent, so the last one can be swapped into its place
+      if (it->second != pending.size() - 1) {
+        prior = std::move(pending.back());
+        m_pending_index[prior.key] = it->second;
+      }
+      pending.pop_back();
+      m_pending_index.erase(change.key);
+      return true;
+    }
+    if (prior.kind == ChangeKind::Erase && change.kind == ChangeKind::Insert) {
+      prior.kind = ChangeKind::Update;
+    } else if (prior.kind != ChangeKind::Insert) {
+      prior.kind = change.kind;
+    }
+    prior.value = std::move(change.value);
+    return true;
+  }
+
+  Map m_values;
+  // Key -> position in the pending batch, only maintained inside transactions
+  std::unordered_map<TKey, std::size_t, THash, TKeyEqual> m_pending_index;
+};
+
+#endif  // OBSERVABLE_CONTAINERS_HPP
@@ -0,0 +1,210 @@
+/**
+ * @brief Observable whose latest value can be polled from any thread
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef READ_MOSTLY_OBSERVABLE_HPP
+#define READ_MOSTLY_OBSERVABLE_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "observable.hpp"
+
+/**
+ * @brief Single-writer sequence lock over a trivially copyable value
+ *
+ * Store never waits. Load retries while a store is in progress, so readers
+ * only spin if the writer is continuously mid-store. The payload is kept in
+ * relaxed atomic words, which keeps the racy reads defined behaviour.
+ */
+template <typename TValueType>
+class SeqlockCell {
+  static_assert(std::is_trivially_copyable_v<TValueType>,
+                "SeqlockCell copies values as raw bytes");
+
+public:
+  SeqlockCell() = default;
+  explicit SeqlockCell(const TValueType& value) { Store(value); }
+
+  SeqlockCell(const SeqlockCell&) = delete;
+  SeqlockCell& operator=(const SeqlockCell&) = delete;
+
+  /**
+   * @brief Publish a new value; must only be called from one thread at a time
+   */
+  void Store(const TValueType& value) noexcept {
+    std::uint64_t buffer[kNumWords]{};
+    std::memcpy(buffer, &value, sizeof(TValueType));
+
+    // Already odd only if a writer died mid-store; that store is finished
+    // here rather than letting the sequence turn even over torn words
+    const auto begin = m_seq.load(std::memory_order_relaxed) | 1;
+    m_seq.store(begin, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t idx{0}; idx < kNumWords; ++idx) {
+      m_words[idx].store(buffer[idx], std::memory_order_relaxed);
+    }
+    m_seq.store(begin + 1, std::memory_order_release);
+  }
+
+  [[nodiscard]] TValueType Load() const noexcept {
+    return LoadVersioned().first;
+  }
+
+  /**
+   * @brief The value together with the Version it was stored as
+   */
+  [[nodiscard]] std::pair<TValueType, std::uint64_t> LoadVersioned()
+      const noexcept {
+    return *TryLoadVersioned(std::numeric_limits<std::size_t>::max());
+  }
+
+  /**
+   * @brief LoadVersioned that gives up after attempts reads overlap a store
+   *
+   * For readers that can't count on the writer finishing, such as one in
+   * another process that may have died mid-store.
+   */
+  [[nodiscard]] std::optional<std::pair<TValueType, std::uint64_t>>
+  TryLoadVersioned(std::size_t attempts) const noexcept {
+    std::uint64_t buffer[kNumWords];
+    for (std::size_t attempt{0}; attempt < attempts; ++attempt) {
+      const auto seq = m_seq.load(std::memory_order_acquire);
+      if (seq & 1) {
+        continue;
+      }
+      for (std::size_t idx{0}; idx < kNumWords; ++idx) {
+        buffer[idx] = m_words[idx].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (m_seq.load(std::memory_order_relaxed) == seq) {
+        std::array<std::byte, sizeof(TValueType)> bytes;
+        std::memcpy(bytes.data(), buffer, sizeof(TValueType));
+        return std::pair{std::bit_cast<TValueType>(bytes), seq / 2};
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Number of completed stores; lets pollers skip unchanged values
+   */
+  [[nodiscard]] std::uint64_t Version() const noexcept {
+    return m_seq.load(std::memory_order_acquire) / 2;
+  }
+
+private:
+  static constexpr std::size_t kNumWords =
+      (sizeof(TValueType) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+  // Sequence and payload share a line; readers need both and the writer
+  // touches both on every store
+  alignas(64) std::atomic<std::uint64_t> m_seq{0};
+  std::atomic<std::uint64_t> m_words[kNumWords]{};
+};
+
+/**
+ * @brief Immutable snapshot published through an atomic shared_ptr
+ *
+ * For values that are not trivially copyable. Readers get a reference counted
+ * snapshot that stays valid however many stores happen after it.
+ */
+template <typename TValueType>
+class SnapshotCell {
+public:
+  SnapshotCell() = default;
+  explicit SnapshotCell(const TValueType& value) { Store(value); }
+
+  SnapshotCell(const SnapshotCell&) = delete;
+  SnapshotCell& operator=(const SnapshotCell&) = delete;
+
+  void Store(const TValueType& value) {
+    auto snapshot = std::make_shared<const TValueType>(value);
+    m_snapshot.store(std::move(snapshot), std::memory_order_release);
+    m_version.fetch_add(1, std::memory_order_release);
+  }
+
+  [[nodiscard]] std::shared_ptr<const TValueType> Load() const noexcept {
+    return m_snapshot.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] std::uint64_t Version() const noexcept {
+    return m_version.load(std::memory_order_acquire);
+  }
+
+private:
+  std::atomic<std::shared_ptr<const TValueType>> m_snapshot;
+  std::atomic<std::uint64_t> m_version{0};
+};
+
+/**
+ * @brief Observable that also publishes every committed value for pollers
+ *
+ * Writes, subscriptions and transactions behave exactly as on Observable and
+ * stay on the owning thread. Load may be called from any thread: trivially
+ * copyable values go through a SeqlockCell and come back by value, anything
+ * else goes through a SnapshotCell and comes back as a shared snapshot.
+ * Values written inside a transaction become visible to Load at commit.
+ */
+template <typename TValueType, typename TUpdater = AssignUpdater<TValueType>>
+class ReadMostlyObservable : public Observable<TValueType, TUpdater> {
+  using Base = Observable<TValueType, TUpdater>;
+
+public:
+  using Cell = std::conditional_t<std::is_trivially_copyable_v<TValueType>,
+                                  SeqlockCell<TValueType>,
+                                  SnapshotCell<TValueType>>;
+
+  ReadMostlyObservable() : Base{} { Attach(); }
+  ReadMostlyObservable(const TValueType& value) : Base{value} { Attach(); }
+  ReadMostlyObservable(TValueType&& value) : Base{std::move(value)} { Attach(); }
+
+  // Pollers on other threads hold on to this object, so it must not move
+  ReadMostlyObservable(ReadMostlyObservable&&) = delete;
+  ReadMostlyObservable& operator=(ReadMostlyObservable&&) = delete;
+
+  // Only values can be assigned: assigning a whole Observable would replace
+  // the subscriber map and with it the subscription that feeds the cell
+  ReadMostlyObservable& operator=(const TValueType& value) {
+    Base::operator=(value);
+    return *this;
+  }
+  ReadMostlyObservable& operator=(TValueType&& value) {
+    Base::operator=(std::move(value));
+    return *this;
+  }
+  ReadMostlyObservable& operator=(Base&&) = delete;
+
+  /**
+   * @brief Latest committed value; safe to call from any thread
+   */
+  [[nodiscard]] decltype(auto) Load() const noexcept { return m_cell.Load(); }
+
+  [[nodiscard]] std::uint64_t Version() const noexcept {
+    return m_cell.Version();
+  }
+
+private:
+  void Attach() {
+    m_cell.Store(this->Value());
+    // Registered first, so the cell is current before any other subscriber runs
+    m_publisher = this->Subscribe(
+        [cell = &m_cell](const TValueType& value) { cell->Store(value); });
+  }
+
+  Cell m_cell;
+  Subscription m_publisher;
+};
+
+#endif  // READ_MOSTLY_OBSERVABLE_HPP
@@ -0,0 +1,509 @@
+/**
+ * @brief Observable published to other processes through shared memory
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef SHARED_OBSERVABLE_HPP
+#define SHARED_OBSERVABLE_HPP
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "observable.hpp"
+#include "read_mostly_observable.hpp"
+
+/**
+ * Region layout, created and sized by the publisher:
+ *
+ *   header: magic, layout version, size and alignment of TValueType,
+ *           publisher generation
+ *   wake word and sleeper count, on their own cache line
+ *   SeqlockCell<TValueType>
+ *
+ * Nothing in it is a pointer, so every process can map it anywhere.
+ */
+inline constexpr std::uint32_t kSharedObservableVersion{2};
+inline constexpr char kSharedObservableMagic[8] = {'M', 'G', 'O', 'B',
+                                                   'S', 'E', 'R', 'V'};
+
+template <typename TValueType>
+struct SharedObservableRegion {
+  char magic[8]{};
+  std::uint32_t version{0};
+  std::uint32_t value_size{0};
+  std::uint32_t value_align{0};
+  // Set last, once the cell holds the initial value
+  std::atomic<std::uint32_t> ready{0};
+  std::atomic<std::uint32_t> closed{0};
+  // Bumped each time a publisher takes the region over from one that died
+  std::atomic<std::uint32_t> generation{0};
+  // Bumped after every store; subscribers sleep on it with FUTEX_WAIT
+  alignas(64) std::atomic<std::uint32_t> wake{0};
+  std::atomic<std::uint32_t> sleepers{0};
+  SeqlockCell<TValueType> cell;
+};
+
+namespace shared_observable_detail {
+
+// std::atomic::wait can't be used here: libstdc++ waits with
+// FUTEX_PRIVATE_FLAG, which only wakes waiters in the same process
+inline long Futex(std::atomic<std::uint32_t>& word, int op,
+                  std::uint32_t value, const timespec* timeout) noexcept {
+  static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) &&
+                std::atomic<std::uint32_t>::is_always_lock_free);
+  return ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), op,
+                   value, timeout, nullptr, 0);
+}
+
+inline void WakeAll(std::atomic<std::uint32_t>& word) noexcept {
+  Futex(word, FUTEX_WAKE, INT_MAX, nullptr);
+}
+
+// Maps size bytes of an shm_open object; null on failure
+inline void* MapRegion(int fd, std::size_t size) noexcept {
+  void* base =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  return base == MAP_FAILED ? nullptr : base;
+}
+
+// The publisher holds a write lock over the whole object for as long as it
+// lives. Open file description locks rather than flock: they are dropped
+// however the publisher exits, and a view can test for one without taking it
+inline bool LockOwner(int fd) noexcept {
+  struct flock lock {};
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  return ::fcntl(fd, F_OFD_SETLK, &lock) == 0;
+}
+
+inline bool OwnerAlive(int fd) noexcept {
+  struct flock lock {};
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  // If the kernel can't say, keep treating the publisher as alive
+  return ::fcntl(fd, F_OFD_GETLK, &lock) != 0 || lock.l_type != F_UNLCK;
+}
+
+template <typename TValueType>
+[[nodiscard]] const char* Validate(
+    const SharedObservableRegion<TValueType>& region) noexcept {
+  if (region.ready.load(std::memory_order_acquire) == 0) {
+    return "not ready";
+  }
+  if (std::memcmp(region.magic, kSharedObservableMagic,
+                  sizeof(kSharedObservableMagic)) != 0) {
+    return "not a shared observable";
+  }
+  if (region.version != kSharedObservableVersion) {
+    return "unsupported version";
+  }
+  if (region.value_size != sizeof(TValueType) ||
+      region.value_align != alignof(TValueType)) {
+    return "value type mismatch";
+  }
+  return nullptr;
+}
+
+}  // namespace shared_observable_detail
+
+/**
+ * @brief Observable whose committed values are also published under a name
+ * in shared memory, for SharedObservableView in other processes
+ *
+ * Writes, subscriptions and transactions behave exactly as on Observable and
+ * stay on the owning thread. Each committed value is copied as raw bytes into
+ * a seqlock cell and subscribers sleeping in other processes are woken; a
+ * store never waits on them. The name follows shm_open's rules, e.g.
+ * "/prices", and belongs to this object while it lives: a lock on the shared
+ * object marks the owner and the destructor unlinks the name. A name left
+ * behind by a publisher that died is taken over, and views still attached to
+ * it carry on with the values stored from then on.
+ */
+template <typename TValueType, typename TUpdater = AssignUpdater<TValueType>>
+class SharedObservable : public Observable<TValueType, TUpdater> {
+  static_assert(std::is_trivially_copyable_v<TValueType>,
+                "SharedObservable copies values between processes as bytes");
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                "Atomics in shared memory must be lock free");
+
+  using Base = Observable<TValueType, TUpdater>;
+  using Region = SharedObservableRegion<TValueType>;
+
+public:
+  /**
+   * @throws std::runtime_error if a live publisher owns name, or a dead one
+   * left it holding a different value type
+   */
+  explicit SharedObservable(std::string name, const TValueType& value = {})
+      : Base{value}, m_name{std::move(name)}, m_fd{Claim(m_name)} {
+    struct stat info {};
+    if (::fstat(m_fd, &info) != 0) {
+      Abandon("cannot stat ");
+    }
+    // Empty only if it was created just now, or by a publisher that died
+    // before sizing it
+    const bool created = info.st_size == 0;
+    if (created && ::ftruncate(m_fd, sizeof(Region)) != 0) {
+      Abandon("cannot size ");
+    }
+    if (!created && static_cast<std::size_t>(info.st_size) != sizeof(Region)) {
+      Abandon("value type mismatch in ");
+    }
+    void* base = shared_observable_detail::MapRegion(m_fd, sizeof(Region));
+    if (base == nullptr) {
+      Abandon("cannot map ");
+    }
+    auto* region = static_cast<Region*>(base);
+    if (created || region->ready.load(std::memory_order_acquire) == 0) {
+      // No view attaches before ready is set, so nobody else is reading
+      m_region = ::new (base) Region{};
+      std::memcpy(m_region->magic, kSharedObservableMagic,
+                  sizeof(kSharedObservableMagic));
+      m_region->version = kSharedObservableVersion;
+      m_region->value_size = sizeof(TValueType);
+      m_region->value_align = alignof(TValueType);
+      m_region->cell.Store(this->Value());
+      m_region->ready.store(1, std::memory_order_release);
+    } else if (const char* problem =
+                   shared_observable_detail::Validate(*region)) {
+      ::munmap(region, sizeof(Region));
+      Abandon(std::string{problem} + " in ");
+    } else {
+      // Left by a publisher that died, possibly in the middle of a store,
+      // which the store here finishes
+      m_region = region;
+      m_region->generation.fetch_add(1, std::memory_order_relaxed);
+      Publish(*m_region, this->Value());
+    }
+    // Registered first, so the region is current before any other subscriber
+    m_publisher = this->Subscribe([region = m_region](const TValueType& last) {
+      Publish(*region, last);
+    });
+  }
+
+  // Views in other processes hold on to the name, so it must not move
+  SharedObservable(SharedObservable&&) = delete;
+  SharedObservable& operator=(SharedObservable&&) = delete;
+
+  /**
+   * @brief Unlinks the name and wakes every view so it can see Closed
+   *
+   * Views that are already attached keep reading the last value.
+   */
+  ~SharedObservable() {
+    m_publisher.Unsubscribe();
+    m_region->closed.store(1, std::memory_order_release);
+    m_region->wake.fetch_add(1, std::memory_order_seq_cst);
+    shared_observable_detail::WakeAll(m_region->wake);
+    ::shm_unlink(m_name.c_str());
+    ::munmap(m_region, sizeof(Region));
+    // Last, so a publisher that opened the name meanwhile finds it unlinked
+    ::close(m_fd);
+  }
+
+  // Only values can be assigned: assigning a whole Observable would replace
+  // the subscriber map and with it the subscription that feeds the region
+  SharedObservable& operator=(const TValueType& value) {
+    Base::operator=(value);
+    return *this;
+  }
+  SharedObservable& operator=(TValueType&& value) {
+    Base::operator=(std::move(value));
+    return *this;
+  }
+  SharedObservable& operator=(Base&&) = delete;
+
+  [[nodiscard]] const std::string& Name() const noexcept { return m_name; }
+
+private:
+  // Opens name, creating it if needed, and takes the owner's lock on it
+  static int Claim(const std::string& name) {
+    for (;;) {
+      const int fd =
+          ::shm_open(name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+      if (fd < 0) {
+        throw std::runtime_error("SharedObservable: cannot create " + name +
+                                 ": " + std::strerror(errno));
+      }
+      if (!shared_observable_detail::LockOwner(fd)) {
+        const int error = errno;
+        ::close(fd);
+        if (error == EAGAIN || error == EACCES) {
+          throw std::runtime_error("SharedObservable: " + name +
+                                   " is already published");
+        }
+        throw std::runtime_error("SharedObservable: cannot lock " + name +
+                                 ": " + std::strerror(error));
+      }
+      struct stat info {};
+      if (::fstat(fd, &info) == 0 && info.st_nlink == 0) {
+        // Opened just before the previous owner unlinked it on the way out;
+        // the name leads to a new object now
+        ::close(fd);
+        continue;
+      }
+      return fd;
+    }
+  }
+
+  // Constructor failure after Claim; the name is left for the next owner
+  [[noreturn]] void Abandon(const std::string& problem) {
+    ::close(m_fd);
+    throw std::runtime_error("SharedObservable: " + problem + m_name);
+  }
+
+  static void Publish(Region& region, const TValueType& value) noexcept {
+    region.cell.Store(value);
+    // Pairs with the sleeper registering before it checks the wake word, so
+    // either the store is seen there or the sleeper is seen here
+    region.wake.fetch_add(1, std::memory_order_seq_cst);
+    if (region.sleepers.load(std::memory_order_seq_cst) != 0) {
+      shared_observable_detail::WakeAll(region.wake);
+    }
+  }
+
+  std::string m_name;
+  int m_fd;
+  Region* m_region{nullptr};
+  Subscription m_publisher;
+};
+
+/**
+ * @brief Subscriber side of a SharedObservable, attached by name
+ *
+ * Load and Version read the shared cell directly. Callbacks subscribed here
+ * run on the thread that calls Poll or Wait, which delivers the newest value
+ * if it changed since the last delivery; values stored in between are
+ * coalesced, as in a transaction. Like Observable, a view belongs to one
+ * thread.
+ *
+ * The value current when the view attaches counts as delivered: it can be
+ * read through Load and Value, but subscribers are only called for values
+ * stored after that.
+ */
+template <typename TValueType>
+class SharedObservableView {
+  static_assert(std::is_trivially_copyable_v<TValueType>,
+                "SharedObservable copies values between processes as bytes");
+
+  using Region = SharedObservableRegion<TValueType>;
+
+public:
+  /**
+   * @throws std::runtime_error if nothing is published under name yet, or
+   * it was published for a different value type
+   */
+  explicit SharedObservableView(const std::string& name)
+      : SharedObservableView{Attach(name)} {}
+
+  SharedObservableView(const SharedObservableView&) = delete;
+  SharedObservableView& operator=(const SharedObservableView&) = delete;
+  SharedObservableView(SharedObservableView&&) = delete;
+  SharedObservableView& operator=(SharedObservableView&&) = delete;
+
+  ~SharedObservableView() {
+    ::munmap(m_region, sizeof(Region));
+    ::close(m_fd);
+  }
+
+  template <typename TFunc>
+  [[nodiscard]] Subscription Subscribe(TFunc&& func)
+    requires std::is_invocable_v<std::decay_t<TFunc>&, const TValueType&>
+  {
+    return m_local.Subscribe(std::forward<TFunc>(func));
+  }
+
+  /**
+   * @brief Newest value in the shared cell, delivered or not
+   *
+   * If the publisher died in the middle of a store, the last delivered value.
+   */
+  [[nodiscard]] TValueType Load() const noexcept {
+    if (auto loaded = Read()) {
+      return loaded->first;
+    }
+    return m_local.Value();
+  }
+
+  /**
+   * @brief Last value handed to subscribers
+   */
+  [[nodiscard]] const TValueType& Value() const noexcept {
+    return m_local.Value();
+  }
+
+  [[nodiscard]] std::uint64_t Version() const noexcept {
+    return m_region->cell.Version();
+  }
+
+  /**
+   * @brief Number of times a new publisher took the name over from one that
+   * died while this view stayed attached to it, or before
+   */
+  [[nodiscard]] std::uint32_t Generation() const noexcept {
+    return m_region->generation.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief The publisher was destroyed or died; no further values will
+   * arrive, unless a new publisher takes a dead one's name over
+   */
+  [[nodiscard]] bool Closed() const noexcept {
+    return m_region->closed.load(std::memory_order_acquire) != 0 ||
+           !shared_observable_detail::OwnerAlive(m_fd);
+  }
+
+  /**
+   * @brief Deliver the newest value if it changed since the last delivery
+   * @return whether subscribers were called
+   */
+  bool Poll() {
+    if (Version() == m_delivered) {
+      return false;
+    }
+    auto loaded = Read();
+    if (!loaded) {
+      return false;
+    }
+    m_delivered = loaded->second;
+    m_local = std::move(loaded->first);
+    return true;
+  }
+
+  /**
+   * @brief Block until a new value arrives and deliver it, or time out
+   *
+   * Checks for a change up to spins times before sleeping on the futex,
+   * trading a busy core for skipping the wake-up latency.
+   * @return whether subscribers were called; false on timeout or Closed
+   */
+  bool Wait(std::chrono::nanoseconds timeout, std::uint32_t spins = 0) {
+    for (std::uint32_t spin{0}; spin < spins; ++spin) {
+      if (Poll()) {
+        return true;
+      }
+    }
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+      const auto wake = m_region->wake.load(std::memory_order_seq_cst);
+      if (Poll()) {
+        return true;
+      }
+      if (Closed()) {
+        return false;
+      }
+      const auto remaining = deadline - std::chrono::steady_clock::now();
+      if (remaining <= std::chrono::nanoseconds::zero()) {
+        return false;
+      }
+      const auto secs =
+          std::chrono::duration_cast<std::chrono::seconds>(remaining);
+      const timespec relative{
+          static_cast<std::time_t>(secs.count()),
+          static_cast<long>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(remaining -
+                                                                   secs)
+                  .count())};
+      m_region->sleepers.fetch_add(1, std::memory_order_seq_cst);
+      // Returns at once if a store bumped the wake word after it was read
+      if (m_region->wake.load(std::memory_order_seq_cst) == wake) {
+        shared_observable_detail::Futex(m_region->wake, FUTEX_WAIT, wake,
+                                        &relative);
+      }
+      m_region->sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  using Versioned = std::pair<TValueType, std::uint64_t>;
+
+  struct Attached {
+    int fd;
+    Region* region;
+    Versioned initial;
+  };
+
+  explicit SharedObservableView(Attached attached)
+      : m_fd{attached.fd},
+        m_region{attached.region},
+        m_delivered{attached.initial.second},
+        m_local{attached.initial.first} {}
+
+  static Attached Attach(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+      throw std::runtime_error("SharedObservableView: cannot open " + name +
+                               ": " + std::strerror(errno));
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 ||
+        static_cast<std::size_t>(info.st_size) < sizeof(Region)) {
+      ::close(fd);
+      throw std::runtime_error("SharedObservableView: not ready " + name);
+    }
+    void* base = shared_observable_detail::MapRegion(fd, sizeof(Region));
+    if (base == nullptr) {
+      ::close(fd);
+      throw std::runtime_error("SharedObservableView: cannot map " + name);
+    }
+    auto* region = static_cast<Region*>(base);
+    const char* problem = shared_observable_detail::Validate(*region);
+    std::optional<Versioned> initial;
+    if (problem == nullptr) {
+      initial = Read(fd, *region);
+      problem = initial ? nullptr : "publisher died mid-store";
+    }
+    if (problem != nullptr) {
+      ::munmap(region, sizeof(Region));
+      ::close(fd);
+      throw std::runtime_error(std::string{"SharedObservableView: "} +
+                               problem + " in " + name);
+    }
+    return {fd, region, *initial};
+  }
+
+  // Reads that overlap a store are retried for as long as the publisher is
+  // alive to finish it; one that died mid-store leaves nothing to read
+  static std::optional<Versioned> Read(int fd, const Region& region) noexcept {
+    constexpr std::size_t kAttemptsPerCheck{1024};
+    for (;;) {
+      if (auto loaded = region.cell.TryLoadVersioned(kAttemptsPerCheck)) {
+        return loaded;
+      }
+      if (!shared_observable_detail::OwnerAlive(fd)) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  [[nodiscard]] std::optional<Versioned> Read() const noexcept {
+    return Read(m_fd, *m_region);
+  }
+
+  int m_fd;
+  Region* m_region;
+  std::uint64_t m_delivered{0};
+  Observable<TValueType> m_local;
+};
+
+#endif  // SHARED_OBSERVABLE_HPP
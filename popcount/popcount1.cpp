@@ -5,26 +5,25 @@
 #include <iostream>
 #include <limits>
 
+// Each entry is the count for the entry with its low bit shifted out, plus
+// that bit. A plain constexpr loop costs the compiler far less than
+// expanding one lambda call per entry over an index_sequence.
 constexpr std::array<std::uint_least8_t, 256> get_bit_count_table() {
-  constexpr auto popcount = [](std::uint_least8_t val) {
-    return (val & 1) + ((val >> 1) & 1) + ((val >> 2) & 1) + ((val >> 3) & 1) +
-           ((val >> 4) & 1) + ((val >> 5) & 1) + ((val >> 6) & 1) +
-           ((val >> 7) & 1);
-  };
-
-  return [&]<std::size_t... NIdxs>(std::index_sequence<NIdxs...>) {
-    std::array<std::uint_least8_t, 256> result;
-    ([&]() { result[NIdxs] = popcount(NIdxs); }(), ...);
-    return result;
-  }(std::make_index_sequence<256>{});
+  std::array<std::uint_least8_t, 256> result{};
+  for (std::size_t idx{1}; idx < result.size(); ++idx) {
+    result[idx] = static_cast<std::uint_least8_t>(result[idx >> 1] + (idx & 1));
+  }
+  return result;
 }
 
+// One table for the program rather than a copy in every popcount_lut call
+inline constexpr auto bit_count_lut = get_bit_count_table();
+
 constexpr int popcount_lut(std::integral auto val) {
   using u_type = std::make_unsigned_t<decltype(val)>;
 
   auto u_val = static_cast<u_type>(val);
   constexpr auto divisions = 1 + ((sizeof(u_type) * CHAR_BIT) / 8);
-  constexpr auto bit_count_lut = get_bit_count_table();
 
   int count{0u};
   for (auto i{0u}; i < divisions; ++i) {
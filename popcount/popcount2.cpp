@@ -36,28 +36,25 @@ struct uint_least {
 template <std::size_t NBitWidth>
 using uint_least_t = uint_least<NBitWidth>::type;
 
+// Filled with a constexpr loop rather than an index_sequence fold, which at
+// a 10 bit width cost the compiler a thousand lambda instantiations per table
 template <std::size_t NBitWidth = 8>
 constexpr auto get_bit_count_table() {
   static_assert(NBitWidth < 32);
-  using entry_type = uint_least_t<NBitWidth>;
   constexpr auto num_entries = 1ul << NBitWidth;
-  using r_type = std::array<std::uint_least8_t, num_entries>;
 
-  constexpr auto popcount = [](entry_type val) {
-    auto count{0u};
-    for (auto i{0u}; i < NBitWidth; ++i) {
-      count += ((val >> i) & 1);
-    }
-    return count;
-  };
-
-  return [&]<std::size_t... NIdxs>(std::index_sequence<NIdxs...>) {
-    std::array<std::uint_least8_t, num_entries> result;
-    ([&]() { result[NIdxs] = popcount(NIdxs); }(), ...);
-    return result;
-  }(std::make_index_sequence<num_entries>{});
+  std::array<std::uint_least8_t, num_entries> result{};
+  for (std::size_t idx{1}; idx < num_entries; ++idx) {
+    result[idx] = static_cast<std::uint_least8_t>(result[idx >> 1] + (idx & 1));
+  }
+  return result;
 }
 
+// One table per width for the program rather than a copy in every
+// popcount_lut call
+template <std::size_t NBitWidth>
+inline constexpr auto bit_count_lut = get_bit_count_table<NBitWidth>();
+
 template <std::size_t NTableBitWidth = 8>
 constexpr int popcount_lut(std::integral auto val) {
   static_assert(NTableBitWidth < 32);
@@ -65,12 +62,11 @@ constexpr int popcount_lut(std::integral auto val) {
 
   auto u_val = static_cast<u_type>(val);
   constexpr auto divisions = 1 + ((sizeof(u_type) * CHAR_BIT) / NTableBitWidth);
-  constexpr auto bit_count_lut = get_bit_count_table<NTableBitWidth>();
   constexpr auto mask = (1ul << (NTableBitWidth)) - 1;
 
   int count{0u};
   for (auto i{0u}; i < divisions; ++i) {
-    count += bit_count_lut[static_cast<uint_least_t<NTableBitWidth>>(mask & u_val)];
+    count += bit_count_lut<NTableBitWidth>[static_cast<uint_least_t<NTableBitWidth>>(mask & u_val)];
     u_val >>= NTableBitWidth;
   }
   return count;
@@ -0,0 +1,151 @@
+/**
+ * @brief Lock per operation containers whose unsafe scope locks once
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef CONCURRENT_SAFE_HPP
+#define CONCURRENT_SAFE_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "unsafe_proxy.hpp"
+
+/**
+ * @brief Container behind a reader/writer lock
+ *
+ * Every call of the safe API takes the lock for just that call and hands
+ * back values, never references, so nothing outlives the lock. unsafe() holds
+ * the lock exclusively for the whole lambda and const_unsafe() holds it
+ * shared, so a batch of unchecked accesses pays for locking once. The lock
+ * lives in the Unsafe handle, which can't be copied or moved out of the
+ * lambda.
+ *
+ * The lock is not recursive: calling the safe API on the same container from
+ * inside one of its unsafe scopes deadlocks.
+ */
+template <typename TContainer>
+struct ConcurrentSafeImpl {
+private:
+  TContainer m_container{};
+  mutable std::shared_mutex m_mutex;
+
+  static constexpr bool kGrowable =
+      requires(TContainer& container, typename TContainer::value_type value) {
+        container.push_back(std::move(value));
+      };
+
+public:
+  using value_type = typename TContainer::value_type;
+
+  template <bool TConst = false>
+  struct Unsafe {
+    Unsafe() = delete;
+    Unsafe(const Unsafe&) = delete;
+    Unsafe& operator=(const Unsafe&) = delete;
+    Unsafe(Unsafe&&) = delete;
+    Unsafe& operator=(Unsafe&&) = delete;
+
+    decltype(auto) operator[](std::size_t idx) const {
+      return m_ref.m_container[idx];
+    }
+
+    std::size_t size() const { return m_ref.m_container.size(); }
+
+    auto begin() const { return m_ref.m_container.begin(); }
+    auto end() const { return m_ref.m_container.end(); }
+
+    void push_back(value_type value) const
+      requires(!TConst && kGrowable)
+    {
+      m_ref.m_container.push_back(std::move(value));
+    }
+
+    void resize(std::size_t count) const
+      requires(!TConst && kGrowable)
+    {
+      m_ref.m_container.resize(count);
+    }
+
+  private:
+    using Ref = std::conditional_t<TConst, const ConcurrentSafeImpl&,
+                                   ConcurrentSafeImpl&>;
+    using Lock = std::conditional_t<TConst, std::shared_lock<std::shared_mutex>,
+                                    std::unique_lock<std::shared_mutex>>;
+
+    Ref m_ref;
+    Lock m_lock;
+
+    Unsafe(Ref ref) : m_ref{ref}, m_lock{ref.m_mutex} {}
+    friend UnsafeProvider<ConcurrentSafeImpl<TContainer>>;
+  };
+
+  std::optional<value_type> get(std::size_t idx) const {
+    std::shared_lock lock{m_mutex};
+    if (idx >= m_container.size()) {
+      return std::nullopt;
+    }
+    return m_container[idx];
+  }
+
+  bool set(std::size_t idx, value_type value) {
+    std::unique_lock lock{m_mutex};
+    if (idx >= m_container.size()) {
+      return false;
+    }
+    m_container[idx] = std::move(value);
+    return true;
+  }
+
+  // Read-modify-write of one element as a single locked step
+  template <typename TFunc>
+  bool update(std::size_t idx, TFunc&& func) {
+    std::unique_lock lock{m_mutex};
+    if (idx >= m_container.size()) {
+      return false;
+    }
+    std::invoke(std::forward<TFunc>(func), m_container[idx]);
+    return true;
+  }
+
+  std::size_t size() const {
+    std::shared_lock lock{m_mutex};
+    return m_container.size();
+  }
+
+  void push_back(value_type value)
+    requires kGrowable
+  {
+    std::unique_lock lock{m_mutex};
+    m_container.push_back(std::move(value));
+  }
+
+  std::optional<value_type> pop_back()
+    requires kGrowable
+  {
+    std::unique_lock lock{m_mutex};
+    if (m_container.empty()) {
+      return std::nullopt;
+    }
+    auto value = std::move(m_container.back());
+    m_container.pop_back();
+    return value;
+  }
+};
+
+template <typename T, std::size_t NSize>
+using ConcurrentSafeArray =
+    UnsafeProvider<ConcurrentSafeImpl<std::array<T, NSize>>>;
+
+template <typename T>
+using ConcurrentSafeVector = UnsafeProvider<ConcurrentSafeImpl<std::vector<T>>>;
+
+#endif  // CONCURRENT_SAFE_HPP
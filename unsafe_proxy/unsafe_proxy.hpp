@@ -0,0 +1,206 @@
+/**
+ * @brief Bounds checked containers with a scoped, unchecked escape hatch
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/18/26
+ */
+
+#ifndef UNSAFE_PROXY_HPP
+#define UNSAFE_PROXY_HPP
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Whether TMemberFunc is a const call operator whose first parameter is a
+// const rvalue reference. Matching the member function type with one partial
+// specialization is cheaper to compile than pulling the parameter out with
+// std::tuple_element and testing it with type traits, and unsafe() checks
+// this for every lambda it is given.
+template <typename TMemberFunc>
+inline constexpr bool takes_const_rvalue_v = false;
+
+template <typename TClassType, typename TReturnType, typename TArg,
+          typename... TArgs>
+inline constexpr bool takes_const_rvalue_v<TReturnType (TClassType::*)(
+    const TArg&&, TArgs...) const> = true;
+
+// A generic lambda is checked as if called with TArg
+template <typename TFunc, typename TArg>
+concept TakesConstRvalue =
+    takes_const_rvalue_v<decltype(&TFunc::template operator()<TArg>)> ||
+    takes_const_rvalue_v<decltype(&TFunc::operator())>;
+
+template <typename T>
+concept ImplementsUnsafe =
+    std::same_as<std::void_t<decltype(std::declval<
+                                      typename T::template Unsafe<false>>())>,
+                 void> &&
+    std::same_as<std::void_t<decltype(std::declval<
+                                      typename T::template Unsafe<true>>())>,
+                 void>;
+
+template <ImplementsUnsafe TUnderlying>
+struct UnsafeProvider : TUnderlying {
+  template <typename TFunc>
+  void unsafe(TFunc&& func)
+    requires TakesConstRvalue<std::remove_reference_t<TFunc>,
+                              typename TUnderlying::template Unsafe<false>>
+  {
+    return std::invoke(std::forward<TFunc>(func),
+                       typename TUnderlying::template Unsafe<false>(
+                           static_cast<TUnderlying&>(*this)));
+  }
+
+  template <typename TFunc>
+  void const_unsafe(TFunc&& func) const
+    requires TakesConstRvalue<std::remove_reference_t<TFunc>,
+                              typename TUnderlying::template Unsafe<true>>
+  {
+    return std::invoke(std::forward<TFunc>(func),
+                       typename TUnderlying::template Unsafe<true>(
+                           static_cast<const TUnderlying&>(*this)));
+  }
+};
+
+template <typename T, std::size_t NSize>
+struct SafeArrayImpl {
+private:
+  std::array<T, NSize> m_array;
+
+public:
+  template <bool TConst = false>
+  struct Unsafe {
+    Unsafe() = delete;
+    Unsafe(const Unsafe&) = delete;
+    Unsafe& operator=(const Unsafe&) = delete;
+    Unsafe(Unsafe&&) = delete;
+    Unsafe& operator=(Unsafe&&) = delete;
+
+    decltype(auto) operator[](std::size_t idx) const {
+      return m_ref.m_array[idx];
+    }
+
+    std::conditional_t<TConst, const SafeArrayImpl&, SafeArrayImpl&> safe()
+        const {
+      return m_ref;
+    }
+
+  private:
+    std::conditional_t<TConst, const SafeArrayImpl&, SafeArrayImpl&> m_ref;
+
+    Unsafe(std::conditional_t<TConst, const SafeArrayImpl&, SafeArrayImpl&> ref)
+        : m_ref{ref} {}
+    friend UnsafeProvider<SafeArrayImpl<T, NSize>>;
+  };
+
+  std::optional<std::reference_wrapper<T>> operator[](std::size_t idx) {
+    if (idx >= NSize) {
+      return std::nullopt;
+    }
+    return std::ref(m_array[idx]);
+  }
+
+  std::optional<std::reference_wrapper<const T>> operator[](std::size_t idx) const {
+    if (idx >= NSize) {
+      return std::nullopt;
+    }
+    return std::cref(m_array[idx]);
+  }
+
+  // The range functions below check [begin, begin + len) once up front and
+  // then run plain loops over the elements, which the compiler can vectorize.
+  // An out of range request does nothing and reports failure.
+
+  std::optional<std::span<T>> slice(std::size_t begin, std::size_t len) {
+    if (!in_range(begin, len)) {
+      return std::nullopt;
+    }
+    return std::span<T>{m_array.data() + begin, len};
+  }
+
+  std::optional<std::span<const T>> slice(std::size_t begin,
+                                          std::size_t len) const {
+    if (!in_range(begin, len)) {
+      return std::nullopt;
+    }
+    return std::span<const T>{m_array.data() + begin, len};
+  }
+
+  bool fill(std::size_t begin, std::size_t len, const T& value) {
+    if (!in_range(begin, len)) {
+      return false;
+    }
+    T* first = m_array.data() + begin;
+    for (std::size_t idx{0}; idx < len; ++idx) {
+      first[idx] = value;
+    }
+    return true;
+  }
+
+  // Copy all of source into the array starting at begin
+  bool copy_from(std::size_t begin, std::span<const T> source) {
+    if (!in_range(begin, source.size())) {
+      return false;
+    }
+    T* first = m_array.data() + begin;
+    for (std::size_t idx{0}; idx < source.size(); ++idx) {
+      first[idx] = source[idx];
+    }
+    return true;
+  }
+
+  // Fill all of destination from the array starting at begin
+  bool copy_to(std::size_t begin, std::span<T> destination) const {
+    if (!in_range(begin, destination.size())) {
+      return false;
+    }
+    const T* first = m_array.data() + begin;
+    for (std::size_t idx{0}; idx < destination.size(); ++idx) {
+      destination[idx] = first[idx];
+    }
+    return true;
+  }
+
+  // Replace each element in the range with func(element)
+  template <typename TFunc>
+  bool transform(std::size_t begin, std::size_t len, TFunc&& func) {
+    if (!in_range(begin, len)) {
+      return false;
+    }
+    T* first = m_array.data() + begin;
+    for (std::size_t idx{0}; idx < len; ++idx) {
+      first[idx] = std::invoke(func, std::as_const(first[idx]));
+    }
+    return true;
+  }
+
+  // Left fold of op over the range, starting from init
+  template <typename TAcc, typename TOp>
+  std::optional<TAcc> reduce(std::size_t begin, std::size_t len, TAcc init,
+                             TOp&& op) const {
+    if (!in_range(begin, len)) {
+      return std::nullopt;
+    }
+    const T* first = m_array.data() + begin;
+    for (std::size_t idx{0}; idx < len; ++idx) {
+      init = std::invoke(op, std::move(init), first[idx]);
+    }
+    return init;
+  }
+
+private:
+  // Written so that begin + len can't overflow
+  static constexpr bool in_range(std::size_t begin, std::size_t len) {
+    return begin <= NSize && len <= NSize - begin;
+  }
+};
+
+template <typename T, std::size_t NSize>
+using SafeArray = UnsafeProvider<SafeArrayImpl<T, NSize>>;
+
+#endif  // UNSAFE_PROXY_HPP
@@ -0,0 +1,214 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_safe.hpp"
+#include "unsafe_proxy.hpp"
+
+namespace {
+
+constexpr std::size_t kSize{4096};
+
+// Keeps the optimizer from discarding the work being measured
+volatile std::uint64_t g_sink{0};
+// The same for work done on several threads at once, where the plain sink
+// would be a data race; each thread adds to it once, when it is done
+std::atomic<std::uint64_t> g_thread_sink{0};
+
+// Loop bounds and fill values come from here so nothing is known at compile
+// time, as in real code; a constant bound lets the compiler drop the checks
+volatile std::size_t g_length{kSize};
+volatile int g_fill{1};
+
+// Makes the compiler assume memory changed, so repetitions aren't folded
+void clobber_memory() { asm volatile("" : : : "memory"); }
+
+template <typename TFunc>
+double ns_per_element(std::size_t reps, TFunc&& func) {
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t rep{0}; rep < reps; ++rep) {
+    func();
+    clobber_memory();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() /
+         static_cast<double>(reps * kSize);
+}
+
+void print(const char* label, double ns) {
+  std::cout << label << '\t' << ns << '\n';
+}
+
+void bench_sum(std::size_t reps) {
+  SafeArray<int, kSize> safe{};
+  std::array<int, kSize> raw{};
+  for (std::size_t idx{0}; idx < kSize; ++idx) {
+    safe[idx]->get() = static_cast<int>(idx);
+    raw[idx] = static_cast<int>(idx);
+  }
+
+  const std::size_t len = g_length;
+  std::cout << "sum of " << kSize << " ints (ns per element)\n";
+  print("std::array loop", ns_per_element(reps, [&] {
+          int sum{0};
+          for (std::size_t idx{0}; idx < len; ++idx) {
+            sum += raw[idx];
+          }
+          g_sink = g_sink + static_cast<std::uint64_t>(sum);
+        }));
+  print("checked operator[]", ns_per_element(reps, [&] {
+          int sum{0};
+          for (std::size_t idx{0}; idx < len; ++idx) {
+            if (const auto element = safe[idx]) {
+              sum += element->get();
+            }
+          }
+          g_sink = g_sink + static_cast<std::uint64_t>(sum);
+        }));
+  print("unsafe operator[]", ns_per_element(reps, [&] {
+          int sum{0};
+          safe.unsafe([&sum, len](const auto&& unsafe_api) {
+            for (std::size_t idx{0}; idx < len; ++idx) {
+              sum += unsafe_api[idx];
+            }
+          });
+          g_sink = g_sink + static_cast<std::uint64_t>(sum);
+        }));
+  print("slice", ns_per_element(reps, [&] {
+          int sum{0};
+          for (const int value : *safe.slice(0, len)) {
+            sum += value;
+          }
+          g_sink = g_sink + static_cast<std::uint64_t>(sum);
+        }));
+  print("reduce", ns_per_element(reps, [&] {
+          const auto sum =
+              safe.reduce(0, len, 0, [](int acc, int value) {
+                return acc + value;
+              });
+          g_sink = g_sink + static_cast<std::uint64_t>(*sum);
+        }));
+}
+
+void bench_fill_transform(std::size_t reps) {
+  SafeArray<int, kSize> safe{};
+  std::array<int, kSize> raw{};
+  const auto step = [](int value) { return value * 3 + 1; };
+
+  const std::size_t len = g_length;
+  const int fill = g_fill;
+  std::cout << "fill then transform " << kSize << " ints (ns per element)\n";
+  print("std::array loop", ns_per_element(reps, [&] {
+          for (std::size_t idx{0}; idx < len; ++idx) {
+            raw[idx] = fill;
+          }
+          for (std::size_t idx{0}; idx < len; ++idx) {
+            raw[idx] = step(raw[idx]);
+          }
+        }));
+  print("checked operator[]", ns_per_element(reps, [&] {
+          for (std::size_t idx{0}; idx < len; ++idx) {
+            if (auto element = safe[idx]) {
+              element->get() = fill;
+            }
+          }
+          for (std::size_t idx{0}; idx < len; ++idx) {
+            if (auto element = safe[idx]) {
+              element->get() = step(element->get());
+            }
+          }
+        }));
+  print("fill + transform", ns_per_element(reps, [&] {
+          safe.fill(0, len, fill);
+          safe.transform(0, len, step);
+        }));
+  g_sink = g_sink + static_cast<std::uint64_t>(raw[kSize - 1]) +
+           static_cast<std::uint64_t>(safe[kSize - 1]->get());
+}
+
+// Total operations per second with every thread running body(thread index)
+template <typename TBody>
+double mops_per_second(std::size_t threads, std::size_t ops_per_thread,
+                       TBody&& body) {
+  std::vector<std::thread> workers;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t idx{0}; idx < threads; ++idx) {
+    workers.emplace_back([&body, idx] { body(idx); });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  const auto us =
+      std::chrono::duration<double, std::micro>(stop - start).count();
+  return static_cast<double>(threads * ops_per_thread) / us;
+}
+
+constexpr std::size_t kSlots{1024};
+constexpr std::size_t kBatch{64};
+
+// Per operation locking against one lock per batch of kBatch operations
+void bench_contention(std::size_t ops_per_thread) {
+  ConcurrentSafeArray<std::uint64_t, kSlots> shared{};
+
+  std::cout << "contended access, " << ops_per_thread
+            << " ops per thread (M ops/s)\n";
+  std::cout << "threads\twrite per op\twrite batched\tread per op\t"
+               "read batched\n";
+  for (std::size_t threads{1}; threads <= 32; threads *= 2) {
+    const auto write_per_op = mops_per_second(threads, ops_per_thread,
+                                              [&](std::size_t thread) {
+      for (std::size_t op{0}; op < ops_per_thread; ++op) {
+        shared.update((thread + op) % kSlots,
+                      [](std::uint64_t& value) { ++value; });
+      }
+    });
+    const auto write_batched = mops_per_second(threads, ops_per_thread,
+                                               [&](std::size_t thread) {
+      for (std::size_t op{0}; op < ops_per_thread; op += kBatch) {
+        shared.unsafe([thread, op](const auto&& unsafe_api) {
+          for (std::size_t idx{op}; idx < op + kBatch; ++idx) {
+            ++unsafe_api[(thread + idx) % kSlots];
+          }
+        });
+      }
+    });
+    const auto read_per_op = mops_per_second(threads, ops_per_thread,
+                                             [&](std::size_t thread) {
+      std::uint64_t sum{0};
+      for (std::size_t op{0}; op < ops_per_thread; ++op) {
+        sum += *shared.get((thread + op) % kSlots);
+      }
+      g_thread_sink.fetch_add(sum, std::memory_order_relaxed);
+    });
+    const auto read_batched = mops_per_second(threads, ops_per_thread,
+                                              [&](std::size_t thread) {
+      std::uint64_t sum{0};
+      for (std::size_t op{0}; op < ops_per_thread; op += kBatch) {
+        shared.const_unsafe([&sum, thread, op](const auto&& unsafe_api) {
+          for (std::size_t idx{op}; idx < op + kBatch; ++idx) {
+            sum += unsafe_api[(thread + idx) % kSlots];
+          }
+        });
+      }
+      g_thread_sink.fetch_add(sum, std::memory_order_relaxed);
+    });
+    std::cout << threads << '\t' << write_per_op << '\t' << write_batched
+              << '\t' << read_per_op << '\t' << read_batched << '\n';
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t reps = argc > 1 ? std::stoul(argv[1]) : 100'000;
+  bench_sum(reps);
+  bench_fill_transform(reps);
+  bench_contention(argc > 2 ? std::stoul(argv[2]) : 1 << 18);
+}